@@ -151,6 +151,7 @@ namespace polyfem
 
 		/* variable to simulations */
 		variable_to_simulations.init(args["variable_to_simulation"], states, variable_sizes);
+		variable_to_simulations.set_solve_in_parallel(args["solver"]["advanced"]["solve_in_parallel"]);
 	}
 
 	void OptState::create_problem()
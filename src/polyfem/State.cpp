@@ -1411,10 +1411,59 @@ namespace polyfem
 
 	void State::build_collision_mesh()
 	{
+		collision_proxy_refined_faces.clear();
+		if (args.contains("/contact/collision_mesh"_json_pointer)
+			&& args.at("/contact/collision_mesh/enabled"_json_pointer).get<bool>()
+			&& !args.at("/contact/collision_mesh"_json_pointer).contains("linear_map")
+			&& args.at("/contact/collision_mesh/refinement_distance"_json_pointer).get<double>() >= 0)
+		{
+			collision_proxy_refined_faces = mesh::select_collision_proxy_refined_faces(
+				bases, geom_bases(), total_local_boundary, mesh->get_body_ids(),
+				obstacle.v(), obstacle.f().size() ? obstacle.f() : obstacle.e(),
+				args.at("/contact/collision_mesh/refinement_distance"_json_pointer));
+		}
+
+		build_collision_mesh(
+			*mesh, n_bases, bases, geom_bases(), total_local_boundary, obstacle,
+			args, [this](const std::string &p) { return resolve_input_path(p); },
+			in_node_to_node, collision_mesh, &collision_proxy_refined_faces);
+	}
+
+	bool State::update_collision_proxy(const Eigen::MatrixXd &sol)
+	{
+		if (collision_proxy_refined_faces.empty())
+			return false;
+
+		const double distance = args["contact"]["collision_mesh"]["refinement_distance"];
+		const Eigen::MatrixXi obstacle_elements = obstacle.f().size() ? obstacle.f() : obstacle.e();
+
+		// Refine the faces that came close to another body, coarsen the ones that moved away by twice the distance
+		const std::vector<std::vector<bool>> needed = mesh::select_collision_proxy_refined_faces(
+			bases, geom_bases(), total_local_boundary, mesh->get_body_ids(),
+			obstacle.v(), obstacle_elements, distance, sol);
+		const std::vector<std::vector<bool>> kept = mesh::select_collision_proxy_refined_faces(
+			bases, geom_bases(), total_local_boundary, mesh->get_body_ids(),
+			obstacle.v(), obstacle_elements, 2 * distance, sol);
+
+		std::vector<std::vector<bool>> refined_faces = needed;
+		for (int lb = 0; lb < refined_faces.size(); lb++)
+			for (int fi = 0; fi < refined_faces[lb].size(); fi++)
+				refined_faces[lb][fi] = needed[lb][fi] || (collision_proxy_refined_faces[lb][fi] && kept[lb][fi]);
+
+		if (refined_faces == collision_proxy_refined_faces)
+			return false;
+
+		// The background output reads the collision mesh
+		wait_for_output();
+
+		POLYFEM_SCOPED_TIMER("Rebuild collision proxy");
+		collision_proxy_refined_faces = refined_faces;
 		build_collision_mesh(
 			*mesh, n_bases, bases, geom_bases(), total_local_boundary, obstacle,
 			args, [this](const std::string &p) { return resolve_input_path(p); },
-			in_node_to_node, collision_mesh);
+			in_node_to_node, collision_mesh, &collision_proxy_refined_faces);
+
+		return true;
 	}
 
 	void State::build_collision_mesh(
@@ -1427,7 +1476,8 @@ namespace polyfem
 		const json &args,
 		const std::function<std::string(const std::string &)> &resolve_input_path,
 		const Eigen::VectorXi &in_node_to_node,
-		ipc::CollisionMesh &collision_mesh)
+		ipc::CollisionMesh &collision_mesh,
+		const std::vector<std::vector<bool>> *refined_faces)
 	{
 		Eigen::MatrixXd collision_vertices;
 		Eigen::VectorXi collision_codim_vids;
@@ -1459,11 +1509,19 @@ namespace polyfem
 					collision_mesh_args["max_edge_length"].get<double>());
 				igl::Timer timer;
 				timer.start();
+				std::vector<std::vector<bool>> rest_refined_faces;
+				if (refined_faces == nullptr && collision_mesh_args["refinement_distance"].get<double>() >= 0)
+				{
+					rest_refined_faces = mesh::select_collision_proxy_refined_faces(
+						bases, geom_bases, total_local_boundary, mesh.get_body_ids(),
+						obstacle.v(), obstacle.f().size() ? obstacle.f() : obstacle.e(),
+						collision_mesh_args["refinement_distance"]);
+				}
 				build_collision_proxy(
 					bases, geom_bases, total_local_boundary, n_bases, mesh.dimension(),
 					collision_mesh_args["max_edge_length"], collision_vertices,
 					collision_triangles, displacement_map_entries,
-					collision_mesh_args["tessellation_type"]);
+					collision_mesh_args["tessellation_type"], refined_faces != nullptr ? *refined_faces : rest_refined_faces);
 				if (collision_triangles.size())
 					igl::edges(collision_triangles, collision_edges);
 				timer.stop();
@@ -1750,6 +1808,7 @@ namespace polyfem
 		// sol.resize(0, 0);
 		// pressure.resize(0, 0);
 		stats.spectrum.setZero();
+		stats.form_timings = json::array();
 
 		igl::Timer timer;
 		timer.start();
@@ -1802,6 +1861,7 @@ namespace polyfem
 			{
 				init_nonlinear_tensor_solve(sol);
 				solve_tensor_nonlinear(sol);
+				stats.form_timings.push_back({{"t", 0}, {"forms", solve_data.form_timings()}});
 				if (optimization_enabled != solver::CacheLevel::None)
 					cache_transient_adjoint_quantities(0, sol, Eigen::MatrixXd::Zero(mesh->dimension(), mesh->dimension()));
 
@@ -1811,6 +1871,9 @@ namespace polyfem
 			}
 		}
 
+		// Include the time steps still being written
+		wait_for_output();
+
 		timer.stop();
 		timings.solving_time = timer.getElapsedTime();
 		logger().info(" took {}s", timings.solving_time);
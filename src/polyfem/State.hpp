@@ -23,6 +23,7 @@
 
 #include <polyfem/solver/SolveData.hpp>
 #include <polyfem/solver/DiffCache.hpp>
+#include <polyfem/solver/forms/ContactForm.hpp>
 
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/utils/ElasticityUtils.hpp>
@@ -31,12 +32,14 @@
 #include <polyfem/assembler/PeriodicBoundary.hpp>
 
 #include <polyfem/io/OutData.hpp>
+#include <polyfem/io/OutputQueue.hpp>
 
 #include <polysolve/linear/Solver.hpp>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -82,7 +85,8 @@ namespace polyfem
 		//-----------------initialization--------------------
 		//---------------------------------------------------
 
-		~State() = default;
+		/// Destructor, waits for the time steps being written in the background
+		~State();
 		/// Constructor
 		State();
 
@@ -352,6 +356,27 @@ namespace polyfem
 		/// @param[in] dt timestep size
 		/// @param[out] sol solution
 		void solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
+		/// solves transient tensor nonlinear problem with an adaptive time step size (rejected steps are rolled back)
+		/// @param[in] time_steps number of time steps of the uniform discretization (defines the final time)
+		/// @param[in] t0 initial times
+		/// @param[in] dt initial timestep size
+		/// @param[out] sol solution
+		void solve_transient_tensor_nonlinear_adaptive(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
+		/// initial guess of a time step: quasi-static extrapolation of the last two steps and reduced-order predictor (when enabled)
+		/// @param[in] prev_sol solution of the step before the last one (empty if unavailable)
+		/// @param[in] step_ratio ratio between the size of this step and the size of the last one
+		/// @param[in,out] sol solution of the last step, replaced by the initial guess
+		/// @param[in] t time step id
+		void predict_transient_solution(const Eigen::MatrixXd &prev_sol, const double step_ratio, Eigen::MatrixXd &sol, const int t);
+		/// records the accepted solution of a time step in the time integrator and updates the forms for the next step (rebuilds them if the collision proxy changes)
+		/// @param[in,out] sol accepted solution
+		/// @param[in] next_time end time of the next step
+		/// @param[in] next_dt size of the next step
+		void advance_time_step(Eigen::MatrixXd &sol, const double next_time, const double next_dt);
+		/// per-step outputs of the transient solves: rest mesh, time integrator state, restart file (and snapshot), and form timings
+		/// @param[in] t time step id
+		/// @param[in] time time at the end of the step
+		void save_transient_step(const int t, const double time);
 		/// initialize the nonlinear solver
 		/// @param[out] sol solution
 		/// @param[in] t (optional) initial time
@@ -380,10 +405,27 @@ namespace polyfem
 		/// @param[out] sol solution
 		/// @param[in] t (optional) time step id
 		void solve_tensor_nonlinear(Eigen::MatrixXd &sol, const int t = 0, const bool init_lagging = true);
+		/// replaces the initial guess of a quasi-static step by the linear extrapolation of the last two steps if it is a better start
+		/// @param[in] prev_sol solution of the step before the last one
+		/// @param[in,out] sol solution of the last step, replaced by the prediction if it is accepted
+		/// @param[in] step_ratio ratio between the size of this step and the size of the last one
+		/// @return true if the prediction is accepted
+		bool extrapolate_quasistatic_solution(const Eigen::MatrixXd &prev_sol, Eigen::MatrixXd &sol, const double step_ratio = 1);
+		/// improves the initial guess of a time step with a few Newton iterations restricted to the predictor subspace of the time integrator
+		/// @param[in,out] sol initial guess, replaced by the prediction if it lowers the energy
+		/// @param[in] t time step id
+		/// @return true if the prediction is accepted
+		bool solve_reduced_order_predictor(Eigen::MatrixXd &sol, const int t);
+		/// restores the time integrator and the forms from the snapshot given in input/data/snapshot (called at the end of init_nonlinear_tensor_solve)
+		/// @param[out] sol solution stored in the snapshot
+		/// @param[in] t time of the next step
+		void load_snapshot(Eigen::MatrixXd &sol, const double t);
 
 		/// factory to create the nl solver depending on input
+		/// @param[in] for_al use the augmented lagrangian nonlinear solver settings
+		/// @param[in] linear_tolerance (optional) relative tolerance of iterative linear solvers (inexact Newton), ignored if not positive
 		/// @return nonlinear solver (eg newton or LBFGS)
-		std::shared_ptr<polysolve::nonlinear::Solver> make_nl_solver(bool for_al) const;
+		std::shared_ptr<polysolve::nonlinear::Solver> make_nl_solver(bool for_al, const double linear_tolerance = 0) const;
 
 		/// periodic BC and periodic mesh utils
 		std::shared_ptr<utils::PeriodicBoundary> periodic_bc;
@@ -530,10 +572,18 @@ namespace polyfem
 			const json &args,
 			const std::function<std::string(const std::string &)> &resolve_input_path,
 			const Eigen::VectorXi &in_node_to_node,
-			ipc::CollisionMesh &collision_mesh);
+			ipc::CollisionMesh &collision_mesh,
+			const std::vector<std::vector<bool>> *refined_faces = nullptr);
 
 		/// @brief extracts the boundary mesh for collision, called in build_basis
 		void build_collision_mesh();
+		/// @brief rebuilds the collision proxy if the faces close to another body changed (only with /contact/collision_mesh/refinement_distance)
+		/// @note The forms keep references to the collision mesh, they need to be rebuilt when it changes
+		/// @param[in] sol current solution
+		/// @return true if the collision mesh was rebuilt
+		bool update_collision_proxy(const Eigen::MatrixXd &sol);
+		/// for each local boundary and each of its faces, true if the collision proxy face is refined (empty if the refinement is not adaptive)
+		std::vector<std::vector<bool>> collision_proxy_refined_faces;
 		void build_periodic_collision_mesh();
 
 		/// checks if vertex is obstacle
@@ -583,6 +633,10 @@ namespace polyfem
 		io::OutRuntimeData timings;
 		/// Other statistics
 		io::OutStatsData stats;
+		/// snapshot file being written in the background
+		std::future<void> snapshot_writer;
+		/// background workers writing the time steps (null if the output is synchronous)
+		std::unique_ptr<io::OutputQueue> output_queue;
 		double starting_min_edge_length = -1;
 		double starting_max_edge_length = -1;
 		double min_boundary_edge_length = -1;
@@ -620,9 +674,28 @@ namespace polyfem
 		/// @brief computes all errors
 		void compute_errors(const Eigen::MatrixXd &sol);
 
-		/// @brief Save a JSON sim file for restarting the simulation at time t
-		/// @param t current time to restart at
-		void save_restart_json(const double t0, const double dt, const int t) const;
+		/// @brief Save a JSON sim file (and the binary snapshot if requested) for restarting the simulation at time t
+		/// @param time current time to restart at
+		/// @param t current time step
+		void save_restart_json(const double time, const int t);
+
+		/// @brief Build the JSON sim file for restarting the simulation at time t
+		/// @param time current time to restart at
+		/// @param t current time step
+		json build_restart_json(const double time, const int t) const;
+
+		/// @brief Save a binary snapshot of the complete solver state (time integrator history and form states) at time step t
+		/// @note The file is written in the background, a new snapshot waits for the previous one to be written
+		/// @param t current time step
+		/// @param restart_json_path restart file written after the snapshot is complete (empty for none)
+		/// @param restart_json content of the restart file
+		void save_snapshot(const int t, const std::string &restart_json_path = "", const json &restart_json = json());
+
+		/// @brief Wait for the snapshot being written in the background (rethrows its errors)
+		void wait_for_snapshot();
+
+		/// @brief Wait for the time steps being written in the background (rethrows their errors)
+		void wait_for_output();
 
 		//-----------PATH management
 		/// Get the root path for the state (e.g., args["root_path"] or ".")
@@ -650,6 +723,12 @@ namespace polyfem
 
 		std::unique_ptr<polysolve::linear::Solver> lin_solver_cached; // matrix factorization of last linear solve
 
+		/// factorization of the last static adjoint matrix, reused while its pattern/values fingerprints match
+		mutable std::unique_ptr<polysolve::linear::Solver> adjoint_solver_cached;
+		mutable size_t adjoint_solver_pattern_hash = 0;
+		mutable size_t adjoint_solver_values_hash = 0;
+		mutable bool adjoint_solver_factorized = false;
+
 		int ndof() const
 		{
 			const int actual_dim = problem->is_scalar() ? 1 : mesh->dimension();
@@ -662,9 +741,29 @@ namespace polyfem
 		// Aux functions for setting up adjoint equations
 		void compute_force_jacobian(const Eigen::MatrixXd &sol, const Eigen::MatrixXd &disp_grad, StiffnessMatrix &hessian);
 		void compute_force_jacobian_prev(const int force_step, const int sol_step, StiffnessMatrix &hessian_prev) const;
+		/// recompute the force Jacobian of a transient step that was not cached (see DiffCache::set_jacobian_memory_budget)
+		/// @param[in] step time step
+		/// @param[out] hessian force Jacobian wrt. the solution of the step, with identity rows for the Dirichlet nodes
+		void recompute_transient_force_jacobian(const int step, StiffnessMatrix &hessian);
+		/// restore the time integrator and the forms to the state of a transient solve
+		/// @param[in] x_prevs, v_prevs, a_prevs history of the time integrator (the most recent first)
+		/// @param[in] t time of the solve
+		/// @param[in] dt time step size of the solve
+		/// @param[in] barrier_stiffness barrier stiffness of the contact form
+		/// @param[in] friction_collision_set lagged friction collisions
+		/// @param[in] friction_plane_contacts lagged friction contacts with the analytic planes
+		void restore_transient_solve_state(
+			const Eigen::MatrixXd &x_prevs,
+			const Eigen::MatrixXd &v_prevs,
+			const Eigen::MatrixXd &a_prevs,
+			const double t,
+			const double dt,
+			const double barrier_stiffness,
+			const ipc::FrictionCollisions &friction_collision_set,
+			const std::vector<solver::ContactForm::PlaneContact> &friction_plane_contacts);
 		// Solves the adjoint PDE for derivatives and caches
 		void solve_adjoint_cached(const Eigen::MatrixXd &rhs);
-		Eigen::MatrixXd solve_adjoint(const Eigen::MatrixXd &rhs) const;
+		Eigen::MatrixXd solve_adjoint(const Eigen::MatrixXd &rhs);
 		// Returns cached adjoint solve
 		Eigen::MatrixXd get_adjoint_mat(int type) const
 		{
@@ -682,7 +781,7 @@ namespace polyfem
 			return diff_cached.adjoint_mat();
 		}
 		Eigen::MatrixXd solve_static_adjoint(const Eigen::MatrixXd &adjoint_rhs) const;
-		Eigen::MatrixXd solve_transient_adjoint(const Eigen::MatrixXd &adjoint_rhs) const;
+		Eigen::MatrixXd solve_transient_adjoint(const Eigen::MatrixXd &adjoint_rhs);
 		// Change geometric node positions
 		void set_mesh_vertex(int v_id, const Eigen::VectorXd &vertex);
 		void get_vertices(Eigen::MatrixXd &vertices) const;
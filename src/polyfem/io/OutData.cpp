@@ -1079,6 +1079,17 @@ namespace polyfem::io
 		}
 	}
 
+	OutGeometryData::SolverValues::SolverValues(const solver::SolveData &solve_data)
+	{
+		if (solve_data.time_integrator != nullptr)
+		{
+			velocity = solve_data.time_integrator->v_prev();
+			acceleration = solve_data.time_integrator->a_prev();
+		}
+		if (solve_data.contact_form != nullptr)
+			barrier_stiffness = solve_data.contact_form->barrier_stiffness();
+	}
+
 	OutGeometryData::ExportOptions::ExportOptions(const json &args, const bool is_mesh_linear, const bool is_problem_scalar, const bool solve_export_to_file)
 	{
 		volume = args["output"]["paraview"]["volume"];
@@ -1213,7 +1224,6 @@ namespace polyfem::io
 		const std::map<int, Eigen::MatrixXd> &polys = state.polys;
 		const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d = state.polys_3d;
 		const assembler::Assembler &assembler = *state.assembler;
-		const std::shared_ptr<time_integrator::ImplicitTimeIntegrator> time_integrator = state.solve_data.time_integrator;
 		const mesh::Mesh &mesh = *state.mesh;
 		const mesh::Obstacle &obstacle = state.obstacle;
 		const assembler::Problem &problem = *state.problem;
@@ -1357,19 +1367,20 @@ namespace polyfem::io
 
 		if (problem.is_time_dependent())
 		{
-			bool is_time_integrator_valid = time_integrator != nullptr;
+			const SolverValues solver_values = opts.solver_values ? *opts.solver_values : SolverValues(state.solve_data);
+			bool is_time_integrator_valid = solver_values.velocity.size() > 0;
 
 			if (opts.velocity)
 			{
 				const Eigen::VectorXd velocity =
-					is_time_integrator_valid ? (time_integrator->v_prev()) : Eigen::VectorXd::Zero(sol.size());
+					is_time_integrator_valid ? solver_values.velocity : Eigen::VectorXd::Zero(sol.size());
 				save_volume_vector_field(state, points, opts, "velocity", velocity, writer);
 			}
 
 			if (opts.acceleration)
 			{
 				const Eigen::VectorXd acceleration =
-					is_time_integrator_valid ? (time_integrator->a_prev()) : Eigen::VectorXd::Zero(sol.size());
+					is_time_integrator_valid ? solver_values.acceleration : Eigen::VectorXd::Zero(sol.size());
 				save_volume_vector_field(state, points, opts, "acceleration", acceleration, writer);
 			}
 		}
@@ -1993,8 +2004,6 @@ namespace polyfem::io
 		const double dhat = state.args["contact"]["dhat"];
 		const double friction_coefficient = state.args["contact"]["friction_coefficient"];
 		const double epsv = state.args["contact"]["epsv"];
-		const std::shared_ptr<solver::ContactForm> &contact_form = state.solve_data.contact_form;
-		const std::shared_ptr<solver::FrictionForm> &friction_form = state.solve_data.friction_form;
 
 		if (opts.solve_export_to_file)
 		{
@@ -2019,7 +2028,8 @@ namespace polyfem::io
 
 			ipc::BarrierPotential barrier_potential(dhat);
 
-			const double barrier_stiffness = contact_form != nullptr ? contact_form->barrier_stiffness() : 1;
+			const SolverValues solver_values = opts.solver_values ? *opts.solver_values : SolverValues(state.solve_data);
+			const double barrier_stiffness = solver_values.barrier_stiffness;
 
 			if (opts.contact_forces)
 			{
@@ -2042,8 +2052,8 @@ namespace polyfem::io
 				ipc::FrictionPotential friction_potential(epsv);
 
 				Eigen::MatrixXd velocities;
-				if (state.solve_data.time_integrator != nullptr)
-					velocities = state.solve_data.time_integrator->v_prev();
+				if (solver_values.velocity.size() > 0)
+					velocities = solver_values.velocity;
 				else
 					velocities = sol;
 				velocities = collision_mesh.map_displacements(utils::unflatten(velocities, collision_mesh.dim()));
@@ -2860,6 +2870,7 @@ namespace polyfem::io
 		// j["time_computing_errors"] = runtime.computing_errors_time;
 
 		j["solver_info"] = solver_info;
+		j["form_timings"] = form_timings;
 
 		j["count_simplex"] = simplex_count;
 		j["count_regular"] = regular_count;
@@ -2956,10 +2967,19 @@ namespace polyfem::io
 		file.flush();
 	}
 
-	RuntimeStatsCSVWriter::RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt)
-		: file(path), state(state), t0(t0), dt(dt)
+	RuntimeStatsCSVWriter::RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt, const bool variable_dt)
+		: file(path), state(state), t0(t0), dt(dt), variable_dt(variable_dt)
 	{
-		file << "step,time,forward,remeshing,global_relaxation,peak_mem,#V,#T" << std::endl;
+		file << "step,time,forward,remeshing,global_relaxation,peak_mem,#V,#T";
+		for (const auto &[name, _] : state.solve_data.named_forms())
+		{
+			form_names.push_back(name);
+			for (const std::string op : {"value", "gradient", "hessian", "max_step_size", "is_step_valid"})
+				file << "," << name << "_" << op;
+		}
+		if (variable_dt)
+			file << ",dt";
+		file << std::endl;
 	}
 
 	RuntimeStatsCSVWriter::~RuntimeStatsCSVWriter()
@@ -2968,6 +2988,11 @@ namespace polyfem::io
 	}
 
 	void RuntimeStatsCSVWriter::write(const int t, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol)
+	{
+		write(t, t0 + dt * t, dt, forward, remeshing, global_relaxation, sol);
+	}
+
+	void RuntimeStatsCSVWriter::write(const int t, const double time, const double step_dt, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol)
 	{
 		total_forward_solve_time += forward;
 		total_remeshing_time += remeshing;
@@ -2987,9 +3012,22 @@ namespace polyfem::io
 		// logger().debug("Peak mem: {} GiB", peak_mem);
 
 		file << fmt::format(
-			"{},{},{},{},{},{},{},{}\n",
-			t, t0 + dt * t, forward, remeshing, global_relaxation, peak_mem,
+			"{},{},{},{},{},{},{},{}",
+			t, time, forward, remeshing, global_relaxation, peak_mem,
 			state.n_bases, state.mesh->n_elements());
+
+		const json form_timings = state.solve_data.form_timings();
+		for (const std::string &name : form_names)
+		{
+			for (const std::string op : {"value", "gradient", "hessian", "max_step_size", "is_step_valid"})
+			{
+				const double time = form_timings.contains(name) ? form_timings[name][op]["time"].get<double>() : 0;
+				file << "," << time;
+			}
+		}
+		if (variable_dt)
+			file << "," << step_dt;
+		file << "\n";
 		file.flush();
 	}
 
@@ -44,6 +44,18 @@ namespace polyfem::io
 	class OutGeometryData
 	{
 	public:
+		/// @brief solver quantities read by the export, captured when a frame is queued so it can be written while the solver moves on
+		struct SolverValues
+		{
+			Eigen::VectorXd velocity;     ///< previous velocity of the time integrator (empty if not time dependent)
+			Eigen::VectorXd acceleration; ///< previous acceleration of the time integrator (empty if not time dependent)
+			double barrier_stiffness = 1; ///< current barrier stiffness of the contact form
+
+			/// @brief capture the current values from the solver
+			/// @param[in] solve_data solver data
+			explicit SolverValues(const solver::SolveData &solve_data);
+		};
+
 		/// @brief different export flags
 		struct ExportOptions
 		{
@@ -75,6 +87,9 @@ namespace polyfem::io
 
 			bool use_hdf5;
 
+			/// captured solver quantities to use instead of the live solver state (null to read the solver)
+			std::shared_ptr<const SolverValues> solver_values;
+
 			/// @brief initialize the flags based on the input args
 			/// @param[in] args input arguments used to set most of the flags
 			/// @param[in] is_mesh_linear if the mesh is linear
@@ -398,6 +413,9 @@ namespace polyfem::io
 		/// the informations varies depending on the solver
 		json solver_info;
 
+		/// per time step timings and call counts of each form (value, gradient, hessian, etc.)
+		json form_timings;
+
 		/// max edge lenght
 		double mesh_size;
 		/// min edge lenght
@@ -523,18 +541,26 @@ namespace polyfem::io
 	class RuntimeStatsCSVWriter
 	{
 	public:
-		RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt);
+		/// @param variable_dt append the size of each step as the last column (for variable time steps)
+		RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt, const bool variable_dt = false);
 		~RuntimeStatsCSVWriter();
 
 		void write(const int t, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol);
 
+		/// @brief Write the statistics of a step of size step_dt ending at time (for variable time steps)
+		void write(const int t, const double time, const double step_dt, const double forward, const double remeshing, const double global_relaxation, const Eigen::MatrixXd &sol);
+
 	protected:
 		std::ofstream file;
 		const State &state;
 		const double t0;
 		const double dt;
+		const bool variable_dt;
 		double total_forward_solve_time = 0;
 		double total_remeshing_time = 0;
 		double total_global_relaxation_time = 0;
+
+		/// names of the forms whose timings are written as columns
+		std::vector<std::string> form_names;
 	};
 } // namespace polyfem::io
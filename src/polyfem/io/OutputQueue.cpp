@@ -0,0 +1,108 @@
+#include "OutputQueue.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace polyfem::io
+{
+	OutputQueue::OutputQueue(const int n_threads, const int max_pending)
+		: max_pending_(std::max(max_pending, 1))
+	{
+		assert(n_threads > 0);
+		for (int i = 0; i < n_threads; ++i)
+			workers_.emplace_back([this]() { run(); });
+	}
+
+	OutputQueue::~OutputQueue()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		task_added_.notify_all();
+
+		for (std::thread &worker : workers_)
+			worker.join();
+
+		if (error_)
+		{
+			try
+			{
+				std::rethrow_exception(error_);
+			}
+			catch (const std::exception &e)
+			{
+				logger().error("Background output failed: {}", e.what());
+			}
+		}
+	}
+
+	void OutputQueue::push(std::function<void()> task)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			// Backpressure: the solver waits instead of piling up copies of the solution
+			task_done_.wait(lock, [this]() { return tasks_.size() < max_pending_ || error_; });
+			rethrow_error();
+			tasks_.push_back(std::move(task));
+		}
+		task_added_.notify_one();
+	}
+
+	void OutputQueue::wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		task_done_.wait(lock, [this]() { return (tasks_.empty() && n_running_ == 0) || error_; });
+		rethrow_error();
+	}
+
+	void OutputQueue::run()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				task_added_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+				if (tasks_.empty())
+					return; // stopped and drained
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+				++n_running_;
+			}
+			// A slot was freed in the queue
+			task_done_.notify_all();
+
+			std::exception_ptr error;
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				--n_running_;
+				if (error && !error_)
+					error_ = error;
+			}
+			task_done_.notify_all();
+		}
+	}
+
+	void OutputQueue::rethrow_error()
+	{
+		// Called with the lock held, the error is reported only once
+		if (error_)
+		{
+			std::exception_ptr error = error_;
+			error_ = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+} // namespace polyfem::io
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// @brief Pool of background threads running output tasks, with a bounded number of pending tasks
+	/// @note Tasks are started in submission order, they also complete in that order only with a single thread
+	class OutputQueue
+	{
+	public:
+		/// @brief Start the worker threads
+		/// @param n_threads Number of worker threads
+		/// @param max_pending Maximum number of tasks waiting to be run, push blocks while the queue is full
+		OutputQueue(const int n_threads, const int max_pending);
+
+		/// @brief Run the remaining tasks and join the workers (errors are logged, not rethrown)
+		~OutputQueue();
+
+		OutputQueue(const OutputQueue &) = delete;
+		OutputQueue &operator=(const OutputQueue &) = delete;
+
+		/// @brief Add a task, waiting for room in the queue (rethrows the error of a failed task)
+		/// @param task Task to run, it must own copies of all the data it reads that can change
+		void push(std::function<void()> task);
+
+		/// @brief Wait for all the tasks to be completed (rethrows the error of a failed task)
+		void wait();
+
+	private:
+		void run();
+		void rethrow_error();
+
+		std::vector<std::thread> workers_;
+		std::deque<std::function<void()>> tasks_;
+		const size_t max_pending_;
+		int n_running_ = 0;
+		bool stop_ = false;
+		std::exception_ptr error_;
+
+		std::mutex mutex_;
+		std::condition_variable task_added_;
+		std::condition_variable task_done_;
+	};
+} // namespace polyfem::io
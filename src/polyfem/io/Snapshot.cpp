@@ -0,0 +1,108 @@
+#include "Snapshot.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace polyfem::io
+{
+	namespace
+	{
+		// Layout: magic, number of entries, then for each entry the name length, the name,
+		// the number of rows and columns, and the column-major values
+		constexpr char MAGIC[8] = {'P', 'F', 'S', 'N', 'A', 'P', '0', '1'};
+
+		void write_int(std::ofstream &out, const int64_t value)
+		{
+			out.write(reinterpret_cast<const char *>(&value), sizeof(int64_t));
+		}
+
+		int64_t read_int(std::ifstream &in)
+		{
+			int64_t value = 0;
+			in.read(reinterpret_cast<char *>(&value), sizeof(int64_t));
+			return value;
+		}
+	} // namespace
+
+	const Eigen::MatrixXd &Snapshot::get(const std::string &name) const
+	{
+		const auto it = entries_.find(name);
+		if (it == entries_.end())
+			log_and_throw_error("Snapshot has no entry named {}", name);
+		return it->second;
+	}
+
+	double Snapshot::get_scalar(const std::string &name) const
+	{
+		const Eigen::MatrixXd &value = get(name);
+		if (value.size() != 1)
+			log_and_throw_error("Snapshot entry {} is not a scalar ({}x{})", name, value.rows(), value.cols());
+		return value(0);
+	}
+
+	void Snapshot::write(const std::string &path) const
+	{
+		const std::string tmp_path = path + ".tmp";
+		{
+			std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+			if (!out.is_open())
+				log_and_throw_error("Unable to open snapshot file {}", tmp_path);
+
+			out.write(MAGIC, sizeof(MAGIC));
+			write_int(out, entries_.size());
+			for (const auto &[name, value] : entries_)
+			{
+				write_int(out, name.size());
+				out.write(name.data(), name.size());
+				write_int(out, value.rows());
+				write_int(out, value.cols());
+				out.write(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(double));
+			}
+
+			if (!out.good())
+				log_and_throw_error("Failed to write snapshot file {}", tmp_path);
+		}
+
+		// A crash while writing never leaves a truncated snapshot behind
+		if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+			log_and_throw_error("Unable to move snapshot file {} to {}", tmp_path, path);
+	}
+
+	void Snapshot::read(const std::string &path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open())
+			log_and_throw_error("Unable to open snapshot file {}", path);
+
+		char magic[sizeof(MAGIC)];
+		in.read(magic, sizeof(magic));
+		if (!in.good() || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			log_and_throw_error("{} is not a snapshot file", path);
+
+		entries_.clear();
+		const int64_t n_entries = read_int(in);
+		for (int64_t i = 0; i < n_entries && in.good(); ++i)
+		{
+			const int64_t name_size = read_int(in);
+			if (!in.good() || name_size < 0)
+				break;
+			std::string name(name_size, '\0');
+			in.read(name.data(), name.size());
+			const int64_t rows = read_int(in);
+			const int64_t cols = read_int(in);
+			if (!in.good() || rows < 0 || cols < 0)
+				break;
+
+			Eigen::MatrixXd &value = entries_[name];
+			value.resize(rows, cols);
+			in.read(reinterpret_cast<char *>(value.data()), value.size() * sizeof(double));
+		}
+
+		if (!in.good() || entries_.size() != size_t(n_entries))
+			log_and_throw_error("Snapshot file {} is truncated", path);
+	}
+} // namespace polyfem::io
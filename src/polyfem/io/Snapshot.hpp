@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <map>
+#include <string>
+
+namespace polyfem::io
+{
+	/// @brief Named dense matrices stored in a compact binary file, used to restart a simulation with its complete solver state
+	class Snapshot
+	{
+	public:
+		/// @brief Store a matrix, replacing any previous entry with the same name
+		/// @param name Name of the entry
+		/// @param value Matrix to store
+		void set(const std::string &name, const Eigen::MatrixXd &value) { entries_[name] = value; }
+
+		/// @brief Store a scalar as a 1x1 matrix
+		/// @param name Name of the entry
+		/// @param value Scalar to store
+		void set(const std::string &name, const double value) { entries_[name] = Eigen::MatrixXd::Constant(1, 1, value); }
+
+		/// @brief Check if an entry exists
+		/// @param name Name of the entry
+		bool has(const std::string &name) const { return entries_.find(name) != entries_.end(); }
+
+		/// @brief Access a stored matrix (throws if the entry does not exist)
+		/// @param name Name of the entry
+		/// @return Stored matrix
+		const Eigen::MatrixXd &get(const std::string &name) const;
+
+		/// @brief Access a stored scalar (throws if the entry does not exist or is not 1x1)
+		/// @param name Name of the entry
+		/// @return Stored scalar
+		double get_scalar(const std::string &name) const;
+
+		/// @brief Write all entries to a binary file, the file is replaced atomically once completely written
+		/// @param path Output file path
+		void write(const std::string &path) const;
+
+		/// @brief Read the entries of a binary file written by write, replacing the current entries
+		/// @param path Input file path
+		void read(const std::string &path);
+
+	private:
+		std::map<std::string, Eigen::MatrixXd> entries_;
+	};
+} // namespace polyfem::io
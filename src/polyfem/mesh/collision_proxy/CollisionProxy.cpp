@@ -9,7 +9,13 @@
 #include <SimpleBVH/BVH.hpp>
 #include <igl/edges.h>
 #include <igl/barycentric_coordinates.h>
+#include <igl/remove_duplicate_vertices.h>
 #include <h5pp/h5pp.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <set>
 // #include <fcpw/fcpw.h>
 
 namespace polyfem::mesh
@@ -68,6 +74,144 @@ namespace polyfem::mesh
 
 			return V;
 		}
+
+		/// @brief Triangulate a triangle whose edges are split in a given number of segments (fan around the centroid).
+		/// Used for the coarse faces next to refined ones, so the proxy has no T-junctions.
+		/// @param[in] n_segments Number of segments of the edges (1, 0) → (0, 1), (0, 1) → (0, 0), and (0, 0) → (1, 0)
+		/// @param[out] UV Barycentric coordinates of the vertices
+		/// @param[out] F Faces (same orientation as regular_grid_triangle_barycentric_coordinates)
+		void transition_triangle_barycentric_coordinates(
+			const std::array<int, 3> &n_segments, Eigen::MatrixXd &UV, Eigen::MatrixXi &F)
+		{
+			const std::array<Eigen::RowVector2d, 3> corners = {{
+				Eigen::RowVector2d(1, 0),
+				Eigen::RowVector2d(0, 1),
+				Eigen::RowVector2d(0, 0),
+			}};
+
+			const int n_boundary = n_segments[0] + n_segments[1] + n_segments[2];
+			if (n_boundary == 3)
+			{
+				// No split edge: a single triangle
+				UV.resize(3, 2);
+				UV << corners[0], corners[1], corners[2];
+				F.resize(1, 3);
+				F << 2, 0, 1;
+				return;
+			}
+
+			UV.resize(n_boundary + 1, 2);
+			UV.row(0).setConstant(1.0 / 3.0);
+			int vi = 1;
+			for (int k = 0; k < 3; k++)
+			{
+				const Eigen::RowVector2d &a = corners[k];
+				const Eigen::RowVector2d &b = corners[(k + 1) % 3];
+				for (int i = 0; i < n_segments[k]; i++)
+					UV.row(vi++) = a + (b - a) * (i / double(n_segments[k]));
+			}
+			assert(vi == UV.rows());
+
+			F.resize(n_boundary, 3);
+			for (int i = 0; i < n_boundary; i++)
+				F.row(i) << 0, 1 + i, 1 + (i + 1) % n_boundary;
+		}
+
+		/// @brief Build a BVH of the element bounding boxes (P1 geometry only)
+		void build_element_bvh(
+			const std::vector<basis::ElementBases> &geom_bases,
+			const int dim,
+			SimpleBVH::BVH &bvh)
+		{
+			// NOTE: this is only implemented for P1 geometry
+			for (const basis::ElementBases &element_bases : geom_bases)
+			{
+				for (const basis::Basis &basis : element_bases.bases)
+				{
+					if (basis.order() != 1)
+						log_and_throw_error("build_collision_proxy_displacement_map() is only implemented for P1 geometry!");
+				}
+			}
+
+			std::vector<std::array<Eigen::Vector3d, 2>> boxes(
+				geom_bases.size(), {{Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()}});
+			for (int i = 0; i < geom_bases.size(); i++)
+			{
+				const Eigen::MatrixXd nodes = geom_bases[i].nodes();
+				boxes[i][0].head(dim) = nodes.colwise().minCoeff();
+				boxes[i][1].head(dim) = nodes.colwise().maxCoeff();
+			}
+
+			bvh.init(boxes);
+		}
+
+		/// @brief Append the displacement map entries of the given proxy vertices
+		void append_displacement_map_entries(
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &geom_bases,
+			const SimpleBVH::BVH &bvh,
+			const int dim,
+			const Eigen::MatrixXd &proxy_vertices,
+			const std::vector<int> &vertex_ids,
+			std::vector<Eigen::Triplet<double>> &displacement_map_entries)
+		{
+			// for each vᵢ in proxy_vertices:
+			//     find closest element (t)
+			//     compute v̂ᵢ = g⁻¹(v) where g is the geometry mapping of t
+			//     for each basis (ϕⱼ) in t:
+			//         set W(i, j) = ϕⱼ(v̂ᵢ)
+			for (const int i : vertex_ids)
+			{
+				Eigen::Vector3d v = Eigen::Vector3d::Zero();
+				v.head(dim) = proxy_vertices.row(i);
+
+				std::vector<unsigned int> candidates;
+				bvh.intersect_box(v, v, candidates);
+
+				// find which element the proxy vertex belongs to
+				int closest_element_id = -1;
+				VectorNd vhat;
+				for (const unsigned int element_id : candidates)
+				{
+					const Eigen::MatrixXd nodes = geom_bases[element_id].nodes();
+					if (dim == 2)
+					{
+						assert(nodes.rows() == 3);
+						Eigen::RowVector3d bc;
+						igl::barycentric_coordinates(
+							proxy_vertices.row(i), nodes.row(0), nodes.row(1), nodes.row(2), bc);
+						vhat = bc.head<2>();
+					}
+					else
+					{
+						assert(dim == 3 && nodes.rows() == 4);
+						Eigen::RowVector4d bc;
+						igl::barycentric_coordinates(
+							proxy_vertices.row(i), nodes.row(0), nodes.row(1), nodes.row(2), nodes.row(3), bc);
+						vhat = bc.head<3>();
+					}
+					if (vhat.minCoeff() >= 0 && vhat.maxCoeff() <= 1 && vhat.sum() <= 1)
+					{
+						closest_element_id = element_id;
+						break;
+					}
+				}
+
+				if (closest_element_id < 0)
+				{
+					// perform a closest point query
+					log_and_throw_error("build_collision_proxy_displacement_map(): closest point query not implemented!");
+				}
+
+				// compute the displacement map entries
+				for (const basis::Basis &basis : bases[closest_element_id].bases)
+				{
+					assert(basis.global().size() == 1);
+					const int j = basis.global()[0].index;
+					displacement_map_entries.emplace_back(i, j, basis(vhat.transpose())(0));
+				}
+			}
+		}
 	} // namespace
 
 	void build_collision_proxy(
@@ -80,7 +224,8 @@ namespace polyfem::mesh
 		Eigen::MatrixXd &proxy_vertices,
 		Eigen::MatrixXi &proxy_faces,
 		std::vector<Eigen::Triplet<double>> &displacement_map_entries,
-		const CollisionProxyTessellation tessellation)
+		const CollisionProxyTessellation tessellation,
+		const std::vector<std::vector<bool>> &refined_faces)
 	{
 		// for each boundary element (f):
 		//     tessilate f with triangles of max edge length (fₜ)
@@ -93,31 +238,108 @@ namespace polyfem::mesh
 		//   - Vᵢ = g(x) instead
 		// • the tessellations of all faces need to be stitched together
 		//   - this means duplicate weights should be removed
+		// • faces not in refined_faces are kept as a single triangle
+		//   - their edges shared with a refined face are split like the refined face (no T-junctions)
+		assert(refined_faces.empty() || refined_faces.size() == total_local_boundary.size());
 
 		std::vector<double> proxy_vertices_list;
 		std::vector<int> proxy_faces_list;
 		std::vector<Eigen::Triplet<double>> displacement_map_entries_tmp;
 
+		// TODO: use max_edge_length to determine the tessellation
+		constexpr int regular_grid_n = 10;
+
 		Eigen::MatrixXd UV;
 		Eigen::MatrixXi F_local;
 		if (tessellation == CollisionProxyTessellation::REGULAR)
 		{
-			// TODO: use max_edge_length to determine the tessellation
-			regular_grid_triangle_barycentric_coordinates(/*n=*/10, UV, F_local);
+			regular_grid_triangle_barycentric_coordinates(regular_grid_n, UV, F_local);
+		}
+		const Eigen::MatrixXd UV_fine = UV;
+		const Eigen::MatrixXi F_local_fine = F_local;
+
+		// Number of segments a refined face splits an edge into (the same as the refined tessellations)
+		const auto n_refined_segments = [&](const Eigen::RowVectorXd &a, const Eigen::RowVectorXd &b) {
+			if (tessellation == CollisionProxyTessellation::REGULAR)
+				return regular_grid_n - 1;
+			return std::max(int(std::ceil((b - a).norm() / max_edge_length)), 1);
+		};
+
+		// Face corners with duplicates merged, and the edges of the refined faces
+		std::vector<std::array<int, 3>> face_corner_ids;
+		std::vector<Eigen::MatrixXd> face_corners;
+		std::set<std::pair<int, int>> refined_edges;
+		const auto edge_key = [](const int a, const int b) { return std::make_pair(std::min(a, b), std::max(a, b)); };
+		if (!refined_faces.empty())
+		{
+			std::vector<double> corners_list;
+			for (const LocalBoundary &local_boundary : total_local_boundary)
+			{
+				for (int fi = 0; fi < local_boundary.size(); fi++)
+				{
+					face_corners.push_back(extract_face_vertices(
+						geom_bases[local_boundary.element_id()], local_boundary.local_primitive_id(fi)));
+					for (const double x : face_corners.back().reshaped<Eigen::RowMajor>())
+						corners_list.push_back(x);
+				}
+			}
+
+			Eigen::MatrixXd unique_corners;
+			Eigen::VectorXi indices, inverse;
+			igl::remove_duplicate_vertices(
+				Eigen::Map<RowMajorMatrixX<double>>(corners_list.data(), corners_list.size() / dim, dim).eval(),
+				/*epsilon=*/1e-5, unique_corners, indices, inverse);
+
+			int face_id = 0;
+			for (int lb = 0; lb < total_local_boundary.size(); lb++)
+			{
+				for (int fi = 0; fi < total_local_boundary[lb].size(); fi++, face_id++)
+				{
+					const std::array<int, 3> ids = {{inverse(3 * face_id), inverse(3 * face_id + 1), inverse(3 * face_id + 2)}};
+					face_corner_ids.push_back(ids);
+					if (refined_faces[lb][fi])
+					{
+						for (int k = 0; k < 3; k++)
+							refined_edges.insert(edge_key(ids[k], ids[(k + 1) % 3]));
+					}
+				}
+			}
 		}
 
-		for (const LocalBoundary &local_boundary : total_local_boundary)
+		int face_id = 0;
+		for (int lb = 0; lb < total_local_boundary.size(); lb++)
 		{
+			const LocalBoundary &local_boundary = total_local_boundary[lb];
 			if (local_boundary.type() != BoundaryType::TRI)
 				log_and_throw_error("build_collision_proxy() is only implemented for tetrahedra!");
 
 			const basis::ElementBases elm = bases[local_boundary.element_id()];
 			const basis::ElementBases g = geom_bases[local_boundary.element_id()];
-			for (int fi = 0; fi < local_boundary.size(); fi++)
+			for (int fi = 0; fi < local_boundary.size(); fi++, face_id++)
 			{
 				const int local_fid = local_boundary.local_primitive_id(fi);
 
-				if (tessellation == CollisionProxyTessellation::IRREGULAR)
+				if (!refined_faces.empty() && !refined_faces[lb][fi])
+				{
+					// Split the edges shared with refined faces, the others stay a single segment
+					const std::array<int, 3> &ids = face_corner_ids[face_id];
+					const Eigen::MatrixXd &corners = face_corners[face_id];
+					std::array<int, 3> n_segments;
+					for (int k = 0; k < 3; k++)
+					{
+						const int k1 = (k + 1) % 3;
+						n_segments[k] = refined_edges.count(edge_key(ids[k], ids[k1]))
+											? n_refined_segments(corners.row(k), corners.row(k1))
+											: 1;
+					}
+					transition_triangle_barycentric_coordinates(n_segments, UV, F_local);
+				}
+				else if (tessellation == CollisionProxyTessellation::REGULAR)
+				{
+					UV = UV_fine;
+					F_local = F_local_fine;
+				}
+				else
 				{
 					// Use the shape of f to determine the tessellation
 					const Eigen::MatrixXd node_positions = extract_face_vertices(g, local_fid);
@@ -174,140 +396,115 @@ namespace polyfem::mesh
 		const Eigen::MatrixXd &proxy_vertices,
 		std::vector<Eigen::Triplet<double>> &displacement_map_entries)
 	{
-		// for each vᵢ in proxy_vertices:
-		//     find closest element (t)
-		//     compute v̂ᵢ = g⁻¹(v) where g is the geometry mapping of t
-		//     for each basis (ϕⱼ) in t:
-		//         set W(i, j) = ϕⱼ(v̂ᵢ)
-
-		// NOTE: this is only implemented for P1 geometry
-		for (const basis::ElementBases &element_bases : geom_bases)
+		SimpleBVH::BVH bvh;
+		build_element_bvh(geom_bases, dim, bvh);
+
+		std::vector<int> vertex_ids(proxy_vertices.rows());
+		std::iota(vertex_ids.begin(), vertex_ids.end(), 0);
+
+		append_displacement_map_entries(
+			bases, geom_bases, bvh, dim, proxy_vertices, vertex_ids, displacement_map_entries);
+	}
+
+	// ========================================================================
+
+	std::vector<std::vector<bool>> select_collision_proxy_refined_faces(
+		const std::vector<basis::ElementBases> &bases,
+		const std::vector<basis::ElementBases> &geom_bases,
+		const std::vector<LocalBoundary> &total_local_boundary,
+		const std::vector<int> &body_ids,
+		const Eigen::MatrixXd &obstacle_vertices,
+		const Eigen::MatrixXi &obstacle_elements,
+		const double refinement_distance,
+		const Eigen::MatrixXd &displacement)
+	{
+		// Bounding boxes of every boundary face and obstacle primitive, with the body they belong to
+		std::vector<std::array<Eigen::Vector3d, 2>> boxes;
+		std::vector<int> box_body_ids;
+
+		const auto add_box = [&](const Eigen::MatrixXd &V, const int body_id) {
+			std::array<Eigen::Vector3d, 2> box = {{Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()}};
+			box[0].head(V.cols()) = V.colwise().minCoeff();
+			box[1].head(V.cols()) = V.colwise().maxCoeff();
+			boxes.push_back(box);
+			box_body_ids.push_back(body_id);
+		};
+
+		std::vector<std::vector<int>> face_box_ids(total_local_boundary.size());
+		for (int lb = 0; lb < total_local_boundary.size(); lb++)
 		{
-			for (const basis::Basis &basis : element_bases.bases)
+			const LocalBoundary &local_boundary = total_local_boundary[lb];
+			const int body_id = body_ids.empty() ? 0 : body_ids[local_boundary.element_id()];
+			for (int fi = 0; fi < local_boundary.size(); fi++)
 			{
-				if (basis.order() != 1)
-					log_and_throw_error("build_collision_proxy_displacement_map() is only implemented for P1 geometry!");
+				const int local_fid = local_boundary.local_primitive_id(fi);
+				Eigen::MatrixXd V = extract_face_vertices(geom_bases[local_boundary.element_id()], local_fid);
+				if (displacement.size())
+				{
+					// Displacement of the face corners
+					const int dim = V.cols();
+					Eigen::MatrixXd UV(3, 2);
+					UV << 1, 0, 0, 1, 0, 0;
+					const Eigen::MatrixXd UVW = uv_to_uvw(UV, local_fid);
+					for (const basis::Basis &basis : bases[local_boundary.element_id()].bases)
+					{
+						assert(basis.global().size() == 1);
+						const int j = basis.global()[0].index;
+						const Eigen::MatrixXd values = basis(UVW);
+						for (int i = 0; i < V.rows(); i++)
+							V.row(i) += values(i) * displacement.col(0).segment(j * dim, dim).transpose();
+					}
+				}
+
+				face_box_ids[lb].push_back(boxes.size());
+				add_box(V, body_id);
 			}
 		}
 
-		// --------------------------------------------------------------------
-		// build a BVH to find which element each proxy vertex belongs to
-		std::vector<std::array<Eigen::Vector3d, 2>> boxes(
-			geom_bases.size(), {{Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()}});
-		for (int i = 0; i < geom_bases.size(); i++)
+		// Obstacles are never part of a simulated body
+		constexpr int obstacle_body_id = std::numeric_limits<int>::min();
+		Eigen::MatrixXd displaced_obstacle = obstacle_vertices;
+		if (displacement.size() && obstacle_vertices.size())
+			displaced_obstacle += utils::unflatten(
+				displacement.col(0).tail(obstacle_vertices.size()).eval(), obstacle_vertices.cols());
+		if (obstacle_elements.size())
 		{
-			const Eigen::MatrixXd nodes = geom_bases[i].nodes();
-			boxes[i][0].head(dim) = nodes.colwise().minCoeff();
-			boxes[i][1].head(dim) = nodes.colwise().maxCoeff();
+			for (int i = 0; i < obstacle_elements.rows(); i++)
+				add_box(displaced_obstacle(obstacle_elements.row(i), Eigen::all), obstacle_body_id);
+		}
+		else
+		{
+			for (int i = 0; i < displaced_obstacle.rows(); i++)
+				add_box(displaced_obstacle.row(i), obstacle_body_id);
 		}
 
 		SimpleBVH::BVH bvh;
 		bvh.init(boxes);
 
-		// --------------------------------------------------------------------
-		// build wide BVH to find closest point on the surface
-
-		// assert(dim == 3);
-		// fcpw::Scene<3> scene;
-		// {
-		// 	std::vector<Eigen::Vector3d> vertices;
-		// 	vertices.reserve(geom_bases.size() * 4);
-		// 	std::vector<std::array<int, 3>> faces;
-		// 	faces.reserve(geom_bases.size() * 4);
-		// 	for (const basis::ElementBases &elm : geom_bases)
-		// 	{
-		// 		const int offset = vertices.size();
-		// 		for (int i = 0; i < 4; i++)
-		// 			vertices.push_back(elm.bases[i].global()[0].node);
-		// 		faces.push_back({{offset + 0, offset + 1, offset + 2}});
-		// 		faces.push_back({{offset + 0, offset + 1, offset + 3}});
-		// 		faces.push_back({{offset + 0, offset + 2, offset + 3}});
-		// 		faces.push_back({{offset + 1, offset + 2, offset + 3}});
-		// 	}
-
-		// 	scene.setObjectTypes({{fcpw::PrimitiveType::Triangle}});
-		// 	scene.setObjectVertexCount(vertices.size(), /*object_id=*/0);
-		// 	scene.setObjectTriangleCount(faces.size(), /*object_id=*/0);
-
-		// 	for (int i = 0; i < vertices.size(); i++)
-		// 	{
-		// 		scene.setObjectVertex(vertices[i].cast<float>(), i, /*object_id=*/0);
-		// 	}
-
-		// 	// specify the triangle indices
-		// 	for (int i = 0; i < faces.size(); i++)
-		// 	{
-		// 		scene.setObjectTriangle(faces[i].data(), i, 0);
-		// 	}
-
-		// 	scene.build(fcpw::AggregateType::Bvh_SurfaceArea, true); // the second boolean argument enables vectorization
-		// }
-
-		// --------------------------------------------------------------------
-
-		for (int i = 0; i < proxy_vertices.rows(); i++)
+		std::vector<std::vector<bool>> refined_faces(total_local_boundary.size());
+		int n_refined = 0, n_faces = 0;
+		for (int lb = 0; lb < total_local_boundary.size(); lb++)
 		{
-			Eigen::Vector3d v = Eigen::Vector3d::Zero();
-			v.head(dim) = proxy_vertices.row(i);
-
-			std::vector<unsigned int> candidates;
-			bvh.intersect_box(v, v, candidates);
-
-			// find which element the proxy vertex belongs to
-			int closest_element_id = -1;
-			VectorNd vhat;
-			for (const unsigned int element_id : candidates)
+			for (const int box_id : face_box_ids[lb])
 			{
-				const Eigen::MatrixXd nodes = geom_bases[element_id].nodes();
-				if (dim == 2)
-				{
-					assert(nodes.rows() == 3);
-					Eigen::RowVector3d bc;
-					igl::barycentric_coordinates(
-						proxy_vertices.row(i), nodes.row(0), nodes.row(1), nodes.row(2), bc);
-					vhat = bc.head<2>();
-				}
-				else
-				{
-					assert(dim == 3 && nodes.rows() == 4);
-					Eigen::RowVector4d bc;
-					igl::barycentric_coordinates(
-						proxy_vertices.row(i), nodes.row(0), nodes.row(1), nodes.row(2), nodes.row(3), bc);
-					vhat = bc.head<3>();
-				}
-				if (vhat.minCoeff() >= 0 && vhat.maxCoeff() <= 1 && vhat.sum() <= 1)
-				{
-					closest_element_id = element_id;
-					break;
-				}
+				const Eigen::Vector3d box_min = boxes[box_id][0].array() - refinement_distance;
+				const Eigen::Vector3d box_max = boxes[box_id][1].array() + refinement_distance;
+
+				std::vector<unsigned int> candidates;
+				bvh.intersect_box(box_min, box_max, candidates);
+
+				const bool is_refined = std::any_of(candidates.begin(), candidates.end(), [&](const unsigned int other) {
+					return box_body_ids[other] != box_body_ids[box_id];
+				});
+				refined_faces[lb].push_back(is_refined);
+				n_refined += is_refined;
+				n_faces++;
 			}
+		}
 
-			if (closest_element_id < 0)
-			{
-				// perform a closest point query
-				log_and_throw_error("build_collision_proxy_displacement_map(): closest point query not implemented!");
-				// fcpw::Interaction<3> cpq_interaction;
-				// scene.findClosestPoint(v.cast<float>(), cpq_interaction);
-
-				// closest_element_id = cpq_interaction.primitiveIndex / 4;
-
-				// const Eigen::MatrixXd nodes = geom_bases[closest_element_id].nodes();
-
-				// assert(dim == 3 && nodes.rows() == 4);
-				// Eigen::RowVector4d bc;
-				// igl::barycentric_coordinates(
-				// 	proxy_vertices.row(i), nodes.row(0), nodes.row(1), nodes.row(2), nodes.row(3), bc);
-				// vhat = bc.head<3>();
-			}
+		logger().debug("Refining {}/{} faces of the collision proxy", n_refined, n_faces);
 
-			// compute the displacement map entries
-			for (const basis::Basis &basis : bases[closest_element_id].bases)
-			{
-				assert(basis.global().size() == 1);
-				const int j = basis.global()[0].index;
-				displacement_map_entries.emplace_back(i, j, basis(vhat.transpose())(0));
-			}
-		}
+		return refined_faces;
 	}
 
 	// ========================================================================
@@ -31,6 +31,7 @@ namespace polyfem::mesh
 	/// @param[out] proxy_faces Output faces of the proxy mesh
 	/// @param[out] displacement_map Output displacement map from proxy mesh to original mesh
 	/// @param[in] tessellation Type of tessellation to use
+	/// @param[in] refined_faces For each local boundary and each of its faces, true if the face is tessellated (empty to tessellate every face); the other faces are kept as a single triangle, except for the edges they share with a tessellated face
 	void build_collision_proxy(
 		const std::vector<basis::ElementBases> &bases,
 		const std::vector<basis::ElementBases> &geom_bases,
@@ -41,7 +42,29 @@ namespace polyfem::mesh
 		Eigen::MatrixXd &proxy_vertices,
 		Eigen::MatrixXi &proxy_faces,
 		std::vector<Eigen::Triplet<double>> &displacement_map,
-		const CollisionProxyTessellation tessellation = CollisionProxyTessellation::REGULAR);
+		const CollisionProxyTessellation tessellation = CollisionProxyTessellation::REGULAR,
+		const std::vector<std::vector<bool>> &refined_faces = {});
+
+	/// @brief Select the boundary faces close to another body, i.e. the only ones that need a refined collision proxy.
+	/// @note The distance is measured between the bounding boxes of the (displaced) face corners, so the selection is conservative.
+	/// @param[in] bases Bases for elements
+	/// @param[in] geom_bases Geometry bases for elements
+	/// @param[in] total_local_boundary Local boundaries for elements
+	/// @param[in] body_ids Body id of each element (empty if there is a single body)
+	/// @param[in] obstacle_vertices Vertices of the obstacles (considered as another body)
+	/// @param[in] obstacle_elements Faces (or edges) of the obstacles, empty to use the obstacle vertices
+	/// @param[in] refinement_distance Faces closer than this distance to another body are refined
+	/// @param[in] displacement Current solution, with the obstacle displacements last (empty to use the rest geometry)
+	/// @return For each local boundary and each of its faces, true if the face is refined
+	std::vector<std::vector<bool>> select_collision_proxy_refined_faces(
+		const std::vector<basis::ElementBases> &bases,
+		const std::vector<basis::ElementBases> &geom_bases,
+		const std::vector<mesh::LocalBoundary> &total_local_boundary,
+		const std::vector<int> &body_ids,
+		const Eigen::MatrixXd &obstacle_vertices,
+		const Eigen::MatrixXi &obstacle_elements,
+		const double refinement_distance,
+		const Eigen::MatrixXd &displacement = Eigen::MatrixXd());
 
 	/// @brief Build a collision proxy displacement map for a given mesh and proxy mesh.
 	/// @param[in] bases Bases for elements
@@ -2,6 +2,8 @@
 
 #include <polyfem/utils/Logger.hpp>
 
+#include <algorithm>
+
 namespace polyfem::solver
 {
 	ALSolver::ALSolver(
@@ -36,16 +38,33 @@ namespace polyfem::solver
 		int al_steps = 0;
 		const int iters = nl_solver->stop_criteria().iterations;
 
+		if (warm_start && lagr_form != nullptr)
+		{
+			// Resume from the weight reached in the previous solve
+			al_weight = std::min(std::max(lagr_form->last_al_weight(), initial_al_weight), max_al_weight);
+		}
+
 		const double initial_error = pen_form->compute_error(sol);
 
 		nl_problem.line_search_begin(sol, tmp_sol);
 
-		while (!std::isfinite(nl_problem.value(tmp_sol))
-			   || !nl_problem.is_step_valid(sol, tmp_sol)
-			   || !nl_problem.is_step_collision_free(sol, tmp_sol))
+		if (warm_start && !is_valid_step(nl_problem, sol, tmp_sol))
+		{
+			nl_problem.line_search_end();
+			if (try_predicted_solution(nl_problem, sol, initial_error))
+				tmp_sol = nl_problem.full_to_reduced(sol);
+			nl_problem.line_search_begin(sol, tmp_sol);
+		}
+
+		while (!is_valid_step(nl_problem, sol, tmp_sol))
 		{
 			nl_problem.line_search_end();
 
+			// Multipliers before the extrapolation, restored if the subsolve fails
+			const Eigen::VectorXd prev_lagr_mults = lagr_form != nullptr ? lagr_form->lagrange_multipliers() : Eigen::VectorXd();
+			if (warm_start && al_steps == 0 && lagr_form != nullptr)
+				lagr_form->extrapolate_lagrangian();
+
 			set_al_weight(nl_problem, sol, al_weight);
 			logger().debug("Solving AL Problem with weight {}", al_weight);
 
@@ -53,6 +72,7 @@ namespace polyfem::solver
 			update_barrier_stiffness(sol);
 			tmp_sol = sol;
 
+			bool subsolve_failed = false;
 			try
 			{
 				nl_solver->minimize(nl_problem, tmp_sol);
@@ -60,6 +80,7 @@ namespace polyfem::solver
 			}
 			catch (const std::runtime_error &e)
 			{
+				subsolve_failed = true;
 			}
 
 			sol = tmp_sol;
@@ -79,6 +100,12 @@ namespace polyfem::solver
 			tmp_sol = nl_problem.full_to_reduced(sol);
 			nl_problem.line_search_begin(sol, tmp_sol);
 
+			if (subsolve_failed && lagr_form != nullptr)
+			{
+				logger().debug("AL subsolve failed, restoring the lagrange multipliers");
+				lagr_form->set_lagrange_multipliers(prev_lagr_mults);
+			}
+
 			if (eta < eta_tol && al_weight < max_al_weight)
 				al_weight *= scaling;
 			else
@@ -89,6 +116,9 @@ namespace polyfem::solver
 		}
 		nl_problem.line_search_end();
 		nl_solver->stop_criteria().iterations = iters;
+
+		if (al_steps > 0 && lagr_form != nullptr)
+			lagr_form->set_last_al_weight(al_weight);
 	}
 
 	void ALSolver::solve_reduced(std::shared_ptr<NLSolver> nl_solver, NLProblem &nl_problem, Eigen::MatrixXd &sol)
@@ -98,9 +128,7 @@ namespace polyfem::solver
 		Eigen::VectorXd tmp_sol = nl_problem.full_to_reduced(sol);
 		nl_problem.line_search_begin(sol, tmp_sol);
 
-		if (!std::isfinite(nl_problem.value(tmp_sol))
-			|| !nl_problem.is_step_valid(sol, tmp_sol)
-			|| !nl_problem.is_step_collision_free(sol, tmp_sol))
+		if (!is_valid_step(nl_problem, sol, tmp_sol))
 			log_and_throw_error("Failed to apply boundary conditions; solve with augmented lagrangian first!");
 
 		// --------------------------------------------------------------------
@@ -125,6 +153,42 @@ namespace polyfem::solver
 		post_subsolve(0);
 	}
 
+	bool ALSolver::is_valid_step(NLProblem &nl_problem, const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
+	{
+		return std::isfinite(nl_problem.value(x1))
+			   && nl_problem.is_step_valid(x0, x1)
+			   && nl_problem.is_step_collision_free(x0, x1);
+	}
+
+	bool ALSolver::try_predicted_solution(NLProblem &nl_problem, Eigen::MatrixXd &sol, const double initial_error)
+	{
+		if (lagr_form == nullptr || initial_error <= 0)
+			return false;
+
+		const Eigen::VectorXd predicted_sol = lagr_form->predicted_solution();
+		if (predicted_sol.size() != sol.size())
+			return false;
+
+		// Same criterion used to accept an AL subsolve
+		const double predicted_error = pen_form->compute_error(predicted_sol);
+		const double predicted_eta = 1 - sqrt(predicted_error / initial_error);
+		if (predicted_eta < eta_tol)
+			return false;
+
+		const Eigen::VectorXd predicted_tmp_sol = nl_problem.full_to_reduced(predicted_sol);
+		nl_problem.line_search_begin(sol, predicted_tmp_sol);
+		const bool is_valid = is_valid_step(nl_problem, sol, predicted_tmp_sol);
+		nl_problem.line_search_end();
+
+		if (!is_valid)
+			return false;
+
+		logger().debug("Skipping AL, the extrapolated solution satisfies the boundary conditions (predicted eta = {})", predicted_eta);
+		sol = nl_problem.reduced_to_full(predicted_tmp_sol);
+		post_skipped_al(predicted_error);
+		return true;
+	}
+
 	void ALSolver::set_al_weight(NLProblem &nl_problem, const Eigen::VectorXd &x, const double weight)
 	{
 		if (pen_form == nullptr || lagr_form == nullptr)
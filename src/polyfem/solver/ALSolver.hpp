@@ -33,9 +33,24 @@ namespace polyfem::solver
 
 		std::function<void(const double)> post_subsolve = [](const double) {};
 
+		/// @brief Start from the weight and (extrapolated) multipliers of the previous solve and try the extrapolated solution before the AL loop
+		bool warm_start = false;
+		/// @brief Called with the predicted boundary error when the AL loop is skipped thanks to the warm start
+		std::function<void(const double)> post_skipped_al = [](const double) {};
+
 	protected:
 		void set_al_weight(NLProblem &nl_problem, const Eigen::VectorXd &x, const double weight);
 
+		/// @brief Check if the step from x0 to the reduced solution x1 (with DBC imposed) is valid
+		/// @note Assumes line_search_begin(x0, x1) has been called
+		bool is_valid_step(NLProblem &nl_problem, const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const;
+
+		/// @brief Try to impose the DBC on the solution extrapolated from the previous time steps
+		/// @param[in,out] sol Current solution, replaced by the prediction if it is valid
+		/// @param[in] initial_error Boundary error of the current solution
+		/// @return True if the prediction is used and the AL loop can be skipped
+		bool try_predicted_solution(NLProblem &nl_problem, Eigen::MatrixXd &sol, const double initial_error);
+
 		std::shared_ptr<BCLagrangianForm> lagr_form;
 		std::shared_ptr<BCPenaltyForm> pen_form;
 		const double initial_al_weight;
@@ -196,8 +196,22 @@ namespace polyfem::solver
 
 			{
 				POLYFEM_SCOPED_TIMER("adjoint solve");
-				for (int i = 0; i < all_states_.size(); i++)
-					all_states_[i]->solve_adjoint_cached(form_->compute_reduced_adjoint_rhs(x, *all_states_[i])); // caches inside state
+				if (solve_in_parallel)
+				{
+					// the adjoint solves do not depend on each other, only the states with variables contribute to the gradient
+					utils::maybe_parallel_for(all_states_.size(), [&](int start, int end, int thread_id) {
+						for (int i = start; i < end; i++)
+						{
+							if (active_state_mask[i])
+								all_states_[i]->solve_adjoint_cached(form_->compute_reduced_adjoint_rhs(x, *all_states_[i])); // caches inside state
+						}
+					});
+				}
+				else
+				{
+					for (int i = 0; i < all_states_.size(); i++)
+						all_states_[i]->solve_adjoint_cached(form_->compute_reduced_adjoint_rhs(x, *all_states_[i])); // caches inside state
+				}
 			}
 
 			{
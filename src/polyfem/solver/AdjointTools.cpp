@@ -672,57 +672,66 @@ namespace polyfem::solver
 		const int time_steps = state.args["time"]["time_steps"];
 		const int bdf_order = get_bdf_order(state);
 
-		Eigen::VectorXd elasticity_term, rhs_term, pressure_term, damping_term, mass_term, contact_term, friction_term;
 		one_form.setZero(state.n_geom_bases * state.mesh->dimension());
 
-		Eigen::VectorXd cur_p, cur_nu;
-		for (int i = time_steps; i > 0; --i)
-		{
-			const int real_order = std::min(bdf_order, i);
-			double beta = time_integrator::BDF::betas(real_order - 1);
-			double beta_dt = beta * dt;
-			const double t = i * dt + t0;
-
-			Eigen::MatrixXd velocity = state.diff_cached.v(i);
-
-			cur_p = adjoint_p.col(i);
-			cur_nu = adjoint_nu.col(i);
-			cur_p(state.boundary_nodes).setZero();
-			cur_nu(state.boundary_nodes).setZero();
+		// each step only reads the cached forward quantities and its own adjoint, the forms' derivative calls are const with respect to the form state
+		auto storage = utils::create_thread_storage(LocalThreadVecStorage(one_form.size()));
 
+		utils::maybe_parallel_for(time_steps, [&](int start, int end, int thread_id) {
+			LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			for (int i_aux = start; i_aux < end; ++i_aux)
 			{
-				state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, velocity, cur_nu, mass_term);
-				state.solve_data.elastic_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i), cur_p, elasticity_term);
-				state.solve_data.body_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i - 1), cur_p, rhs_term);
-				state.solve_data.pressure_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i), cur_p, pressure_term);
-				pressure_term = state.basis_nodes_to_gbasis_nodes * pressure_term;
+				const int i = time_steps - i_aux;
+				const int real_order = std::min(bdf_order, i);
+				double beta = time_integrator::BDF::betas(real_order - 1);
+				double beta_dt = beta * dt;
+				const double t = i * dt + t0;
 
-				if (state.solve_data.damping_form)
-					state.solve_data.damping_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i - 1), cur_p, damping_term);
-				else
-					damping_term.setZero(mass_term.size());
+				Eigen::MatrixXd velocity = state.diff_cached.v(i);
 
-				if (state.is_contact_enabled())
-				{
-					state.solve_data.contact_form->force_shape_derivative(state.diff_cached.collision_set(i), state.diff_cached.u(i), cur_p, contact_term);
-					contact_term = state.basis_nodes_to_gbasis_nodes * contact_term;
-					// contact_term /= beta_dt * beta_dt;
-				}
-				else
-					contact_term.setZero(mass_term.size());
+				Eigen::VectorXd cur_p = adjoint_p.col(i);
+				Eigen::VectorXd cur_nu = adjoint_nu.col(i);
+				cur_p(state.boundary_nodes).setZero();
+				cur_nu(state.boundary_nodes).setZero();
 
-				if (state.solve_data.friction_form)
+				Eigen::VectorXd elasticity_term, rhs_term, pressure_term, damping_term, mass_term, contact_term, friction_term;
 				{
-					state.solve_data.friction_form->force_shape_derivative(state.diff_cached.u(i - 1), state.diff_cached.u(i), cur_p, state.diff_cached.friction_collision_set(i), friction_term);
-					friction_term = state.basis_nodes_to_gbasis_nodes * (friction_term / beta);
-					// friction_term /= beta_dt * beta_dt;
+					state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, velocity, cur_nu, mass_term);
+					state.solve_data.elastic_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i), cur_p, elasticity_term);
+					state.solve_data.body_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i - 1), cur_p, rhs_term);
+					state.solve_data.pressure_form->force_shape_derivative(state.n_geom_bases, t, state.diff_cached.u(i), cur_p, pressure_term);
+					pressure_term = state.basis_nodes_to_gbasis_nodes * pressure_term;
+
+					if (state.solve_data.damping_form)
+						state.solve_data.damping_form->force_shape_derivative(t, state.n_geom_bases, state.diff_cached.u(i), state.diff_cached.u(i - 1), cur_p, damping_term);
+					else
+						damping_term.setZero(mass_term.size());
+
+					if (state.is_contact_enabled())
+					{
+						state.solve_data.contact_form->force_shape_derivative(state.diff_cached.collision_set(i), state.diff_cached.u(i), cur_p, contact_term);
+						contact_term = state.basis_nodes_to_gbasis_nodes * contact_term;
+						// contact_term /= beta_dt * beta_dt;
+					}
+					else
+						contact_term.setZero(mass_term.size());
+
+					if (state.solve_data.friction_form)
+					{
+						state.solve_data.friction_form->force_shape_derivative(state.diff_cached.u(i - 1), state.diff_cached.u(i), cur_p, state.diff_cached.friction_collision_set(i), friction_term);
+						friction_term = state.basis_nodes_to_gbasis_nodes * (friction_term / beta);
+						// friction_term /= beta_dt * beta_dt;
+					}
+					else
+						friction_term.setZero(mass_term.size());
 				}
-				else
-					friction_term.setZero(mass_term.size());
+
+				local_storage.vec += beta_dt * (elasticity_term + rhs_term + pressure_term + damping_term + contact_term + friction_term + mass_term);
 			}
+		});
 
-			one_form += beta_dt * (elasticity_term + rhs_term + pressure_term + damping_term + contact_term + friction_term + mass_term);
-		}
+		for (const LocalThreadVecStorage &local_storage : storage)
+			one_form += local_storage.vec;
 
 		// time step 0
 		Eigen::VectorXd sum_alpha_p;
@@ -736,6 +745,7 @@ namespace polyfem::solver
 			}
 		}
 		sum_alpha_p(state.boundary_nodes).setZero();
+		Eigen::VectorXd mass_term;
 		state.solve_data.inertia_form->force_shape_derivative(state.mesh->is_volume(), state.n_geom_bases, t0, state.bases, state.geom_bases(), *(state.mass_matrix_assembler), state.mass_ass_vals_cache, state.diff_cached.v(0), sum_alpha_p, mass_term);
 
 		one_form += mass_term;
@@ -802,46 +812,42 @@ namespace polyfem::solver
 
 		one_form.setZero(1);
 
-		std::shared_ptr<time_integrator::ImplicitTimeIntegrator> time_integrator = 
-		 time_integrator::ImplicitTimeIntegrator::construct_time_integrator(state.args["time"]["integrator"]);
-		{
-			Eigen::MatrixXd solution, velocity, acceleration;
-			solution = state.diff_cached.u(0);
-			state.initial_velocity(velocity);
-			state.initial_acceleration(acceleration);
-			if (state.initial_vel_update.size() == state.ndof())
-				velocity = state.initial_vel_update;
-			const double dt = state.args["time"]["dt"];
-			time_integrator->init(solution, velocity, acceleration, dt);
-		}
+		// the surface velocities are the ones cached by the forward solve, so the steps do not need to replay the time integrator
+		auto storage = utils::create_thread_storage(LocalThreadVecStorage(one_form.size()));
 
-		for (int t = 1; t <= time_steps; ++t)
-		{
-			const int real_order = std::min(bdf_order, t);
-			double beta = time_integrator::BDF::betas(real_order - 1);
-
-			const Eigen::MatrixXd surface_solution_prev = state.collision_mesh.vertices(utils::unflatten(state.diff_cached.u(t - 1), dim));
-			// const Eigen::MatrixXd surface_solution = state.collision_mesh.vertices(utils::unflatten(state.diff_cached.u(t), dim));
-
-			const Eigen::MatrixXd surface_velocities = state.collision_mesh.map_displacements(utils::unflatten(time_integrator->compute_velocity(state.diff_cached.u(t)), state.collision_mesh.dim()));
-			time_integrator->update_quantities(state.diff_cached.u(t));
-
-			Eigen::MatrixXd force = state.collision_mesh.to_full_dof(
-				-state.solve_data.friction_form->friction_potential().force(
-					state.diff_cached.friction_collision_set(t),
-					state.collision_mesh,
-					state.collision_mesh.rest_positions(),
-					/*lagged_displacements=*/surface_solution_prev,
-					surface_velocities,
-					state.solve_data.contact_form->barrier_potential(),
-					state.solve_data.contact_form->barrier_stiffness(),
-					0, true));
-
-			Eigen::VectorXd cur_p = adjoint_p.col(t);
-			cur_p(state.boundary_nodes).setZero();
-
-			one_form(0) += dot(cur_p, force) * beta * dt;
-		}
+		utils::maybe_parallel_for(time_steps, [&](int start, int end, int thread_id) {
+			LocalThreadVecStorage &local_storage = utils::get_local_thread_storage(storage, thread_id);
+			for (int t_aux = start; t_aux < end; ++t_aux)
+			{
+				const int t = time_steps - t_aux;
+				const int real_order = std::min(bdf_order, t);
+				double beta = time_integrator::BDF::betas(real_order - 1);
+
+				const Eigen::MatrixXd surface_solution_prev = state.collision_mesh.vertices(utils::unflatten(state.diff_cached.u(t - 1), dim));
+				// const Eigen::MatrixXd surface_solution = state.collision_mesh.vertices(utils::unflatten(state.diff_cached.u(t), dim));
+
+				const Eigen::MatrixXd surface_velocities = state.collision_mesh.map_displacements(utils::unflatten(state.diff_cached.v(t), state.collision_mesh.dim()));
+
+				Eigen::MatrixXd force = state.collision_mesh.to_full_dof(
+					-state.solve_data.friction_form->friction_potential().force(
+						state.diff_cached.friction_collision_set(t),
+						state.collision_mesh,
+						state.collision_mesh.rest_positions(),
+						/*lagged_displacements=*/surface_solution_prev,
+						surface_velocities,
+						state.solve_data.contact_form->barrier_potential(),
+						state.solve_data.contact_form->barrier_stiffness(),
+						0, true));
+
+				Eigen::VectorXd cur_p = adjoint_p.col(t);
+				cur_p(state.boundary_nodes).setZero();
+
+				local_storage.vec(0) += dot(cur_p, force) * beta * dt;
+			}
+		});
+
+		for (const LocalThreadVecStorage &local_storage : storage)
+			one_form += local_storage.vec;
 	}
 
 	void AdjointTools::dJ_damping_transient_adjoint_term(
@@ -961,30 +967,32 @@ namespace polyfem::solver
 		const int n_pressure_dof = boundary_ids.size();
 
 		one_form.setZero(time_steps * n_pressure_dof);
-		Eigen::VectorXd cur_p, cur_nu;
-		for (int i = time_steps; i > 0; --i)
-		{
-			const int real_order = std::min(bdf_order, i);
-			double beta = time_integrator::BDF::betas(real_order - 1);
-			double beta_dt = beta * dt;
-			const double t = i * dt + t0;
 
-			cur_p = adjoint_p.col(i);
-			cur_nu = adjoint_nu.col(i);
-			cur_p(state.boundary_nodes).setZero();
-			cur_nu(state.boundary_nodes).setZero();
-
-			for (int b = 0; b < boundary_ids.size(); ++b)
+		// every step writes its own segment of one_form, no reduction needed
+		utils::maybe_parallel_for(time_steps, [&](int start, int end, int thread_id) {
+			for (int i_aux = start; i_aux < end; ++i_aux)
 			{
-				double pressure_term = state.solve_data.pressure_form->force_pressure_derivative(
-					state.n_geom_bases,
-					t,
-					boundary_ids[b],
-					state.diff_cached.u(i),
-					cur_p);
-				one_form((i - 1) * n_pressure_dof + b) = -beta_dt * pressure_term;
+				const int i = time_steps - i_aux;
+				const int real_order = std::min(bdf_order, i);
+				double beta = time_integrator::BDF::betas(real_order - 1);
+				double beta_dt = beta * dt;
+				const double t = i * dt + t0;
+
+				Eigen::VectorXd cur_p = adjoint_p.col(i);
+				cur_p(state.boundary_nodes).setZero();
+
+				for (int b = 0; b < boundary_ids.size(); ++b)
+				{
+					double pressure_term = state.solve_data.pressure_form->force_pressure_derivative(
+						state.n_geom_bases,
+						t,
+						boundary_ids[b],
+						state.diff_cached.u(i),
+						cur_p);
+					one_form((i - 1) * n_pressure_dof + b) = -beta_dt * pressure_term;
+				}
 			}
-		}
+		});
 	}
 
 	void AdjointTools::dJ_du_step(
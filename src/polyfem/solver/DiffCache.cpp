@@ -0,0 +1,112 @@
+#include "DiffCache.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace polyfem::solver
+{
+	namespace
+	{
+		template <typename T>
+		void write_array(std::ofstream &out, const T *data, const size_t size)
+		{
+			out.write(reinterpret_cast<const char *>(data), size * sizeof(T));
+		}
+
+		template <typename T>
+		void read_array(std::ifstream &in, T *data, const size_t size)
+		{
+			in.read(reinterpret_cast<char *>(data), size * sizeof(T));
+		}
+	} // namespace
+
+	std::atomic<int> DiffCache::next_id_{0};
+
+	void DiffCache::set_spill_file(const std::string &path)
+	{
+		if (path != spill_path_)
+			remove_spill_file();
+		spill_path_ = path;
+	}
+
+	void DiffCache::remove_spill_file()
+	{
+		std::fill(spill_offsets_.begin(), spill_offsets_.end(), -1);
+		spill_size_ = 0;
+		if (spill_path_.empty())
+			return;
+
+		std::error_code ec;
+		std::filesystem::remove(spill_path_, ec);
+		if (ec)
+			logger().warn("Unable to remove the adjoint spill file {}: {}", spill_path_, ec.message());
+	}
+
+	void DiffCache::init_spill_file(const int n_time_steps)
+	{
+		spill_offsets_.assign(n_time_steps + 1, -1);
+		spill_size_ = 0;
+		if (spill_path_.empty())
+			return;
+
+		std::ofstream out(spill_path_, std::ios::binary | std::ios::trunc);
+		if (!out.good())
+			log_and_throw_error("Unable to create the adjoint spill file {}", spill_path_);
+	}
+
+	void DiffCache::spill_gradu_h(const int step, const StiffnessMatrix &mat)
+	{
+		StiffnessMatrix compressed;
+		if (!mat.isCompressed())
+		{
+			compressed = mat;
+			compressed.makeCompressed();
+		}
+		const StiffnessMatrix &gradu_h = mat.isCompressed() ? mat : compressed;
+
+		std::ofstream out(spill_path_, std::ios::binary | std::ios::app);
+		if (!out.good())
+			log_and_throw_error("Unable to write the adjoint spill file {}", spill_path_);
+
+		// Compressed sparse storage: sizes, outer indices, inner indices, values
+		using StorageIndex = StiffnessMatrix::StorageIndex;
+		const int64_t header[3] = {gradu_h.rows(), gradu_h.cols(), gradu_h.nonZeros()};
+		write_array(out, header, 3);
+		write_array(out, gradu_h.outerIndexPtr(), gradu_h.outerSize() + 1);
+		write_array(out, gradu_h.innerIndexPtr(), gradu_h.nonZeros());
+		write_array(out, gradu_h.valuePtr(), gradu_h.nonZeros());
+
+		spill_offsets_[step] = spill_size_;
+		spill_size_ += 3 * sizeof(int64_t)
+					   + (gradu_h.outerSize() + 1 + gradu_h.nonZeros()) * sizeof(StorageIndex)
+					   + gradu_h.nonZeros() * sizeof(double);
+	}
+
+	StiffnessMatrix DiffCache::load_gradu_h(int step) const
+	{
+		assert(is_gradu_h_spilled(step));
+		if (step < 0)
+			step += spill_offsets_.size();
+
+		std::ifstream in(spill_path_, std::ios::binary);
+		in.seekg(spill_offsets_[step]);
+
+		int64_t header[3];
+		read_array(in, header, 3);
+
+		StiffnessMatrix gradu_h(header[0], header[1]);
+		gradu_h.resizeNonZeros(header[2]);
+		read_array(in, gradu_h.outerIndexPtr(), gradu_h.outerSize() + 1);
+		read_array(in, gradu_h.innerIndexPtr(), header[2]);
+		read_array(in, gradu_h.valuePtr(), header[2]);
+
+		if (!in.good())
+			log_and_throw_error("Unable to read step {} from the adjoint spill file {}", step, spill_path_);
+
+		return gradu_h;
+	}
+} // namespace polyfem::solver
@@ -6,6 +6,10 @@
 #include <ipc/collisions/collisions.hpp>
 #include <ipc/friction/friction_collisions.hpp>
 
+#include <atomic>
+#include <ios>
+#include <string>
+
 namespace polyfem::solver
 {
 	enum class CacheLevel
@@ -18,6 +22,11 @@ namespace polyfem::solver
 	class DiffCache
 	{
 	public:
+		DiffCache() : id_(next_id_++) {}
+		DiffCache(const DiffCache &) = delete;
+		DiffCache &operator=(const DiffCache &) = delete;
+		~DiffCache() { remove_spill_file(); }
+
 		void init(const int dimension, const int ndof, const int n_time_steps = 0)
 		{
 			cur_size_ = 0;
@@ -28,11 +37,17 @@ namespace polyfem::solver
 			if (n_time_steps_ > 0)
 			{
 				bdf_order_.setZero(n_time_steps + 1);
+				time_.setZero(n_time_steps + 1);
+				dt_.setZero(n_time_steps + 1);
 				v_.setZero(ndof, n_time_steps + 1);
 				acc_.setZero(ndof, n_time_steps + 1);
 				// gradu_h_prev_.resize(n_time_steps + 1);
 			}
-			gradu_h_.resize(n_time_steps + 1);
+			gradu_h_.assign(n_time_steps + 1, StiffnessMatrix());
+			jacobian_memory_used_ = 0;
+			last_jacobian_memory_ = 0;
+			init_spill_file(n_time_steps);
+			barrier_stiffness_.assign(n_time_steps + 1, 0);
 			collision_set_.resize(n_time_steps + 1);
  			friction_collision_set_.resize(n_time_steps + 1);
 		}
@@ -57,21 +72,40 @@ namespace polyfem::solver
 		void cache_quantities_transient(
 			const int cur_step,
 			const int cur_bdf_order,
+			const double time,
+			const double dt,
 			const Eigen::MatrixXd &u,
 			const Eigen::MatrixXd &v,
 			const Eigen::MatrixXd &acc,
 			const StiffnessMatrix &gradu_h,
 			// const StiffnessMatrix &gradu_h_prev,
 			const ipc::Collisions &collision_set,
-			const ipc::FrictionCollisions &friction_collision_set)
+			const ipc::FrictionCollisions &friction_collision_set,
+			const double barrier_stiffness = 0)
 		{
 			bdf_order_(cur_step) = cur_bdf_order;
+			time_(cur_step) = time;
+			dt_(cur_step) = dt;
 
 			u_.col(cur_step) = u;
 			v_.col(cur_step) = v;
 			acc_.col(cur_step) = acc;
 
-			gradu_h_[cur_step] = gradu_h;
+			if (!spill_path_.empty() && cur_step > 0)
+			{
+				gradu_h_[cur_step] = StiffnessMatrix();
+				spill_gradu_h(cur_step, gradu_h);
+			}
+			else if (gradu_h.nonZeros() > 0 && can_store_jacobian(gradu_h))
+			{
+				gradu_h_[cur_step] = gradu_h;
+				jacobian_memory_used_ += jacobian_memory(gradu_h);
+			}
+			else // not assembled or over the budget
+				gradu_h_[cur_step] = StiffnessMatrix();
+			if (gradu_h.nonZeros() > 0)
+				last_jacobian_memory_ = jacobian_memory(gradu_h);
+			barrier_stiffness_[cur_step] = barrier_stiffness;
 			// gradu_h_prev_[cur_step] = gradu_h_prev;
 
 			collision_set_[cur_step] = collision_set;
@@ -95,6 +129,61 @@ namespace polyfem::solver
             cur_size_++;
         }
 
+		/// @brief Limit the memory used by the force Jacobians of transient problems, the others are recomputed in the adjoint solve
+		/// @param budget Memory budget in bytes (negative for no limit)
+		void set_jacobian_memory_budget(const double budget) { jacobian_memory_budget_ = budget; }
+
+		/// @brief Is the next force Jacobian expected to fit in the memory budget (estimated from the last one)?
+		/// @note Used to skip the assembly of Jacobians that would be dropped, a budget of zero never stores any Jacobian
+		bool has_jacobian_budget() const
+		{
+			if (jacobian_memory_budget_ < 0)
+				return true;
+			return jacobian_memory_budget_ > 0 && jacobian_memory_used_ + last_jacobian_memory_ <= jacobian_memory_budget_;
+		}
+
+		/// @brief Does this force Jacobian fit in the memory budget?
+		/// @param gradu_h Force Jacobian to store
+		bool can_store_jacobian(const StiffnessMatrix &gradu_h) const
+		{
+			if (jacobian_memory_budget_ < 0)
+				return true;
+			return jacobian_memory_budget_ > 0 && jacobian_memory_used_ + jacobian_memory(gradu_h) <= jacobian_memory_budget_;
+		}
+
+		/// @brief Write the force Jacobians of transient problems to a binary file instead of keeping them in memory
+		/// @note The previous spill file is removed if the path changes
+		/// @param path Path of the file (empty to keep the Jacobians in memory)
+		void set_spill_file(const std::string &path);
+
+		/// @brief Identifier of this cache, unique in the process (e.g., to name the spill file of each state)
+		int id() const { return id_; }
+
+		/// @brief Path of the file the force Jacobians are written to (empty if they are kept in memory)
+		const std::string &spill_file() const { return spill_path_; }
+
+		/// @brief Delete the spill file and forget the spilled Jacobians
+		void remove_spill_file();
+
+		/// @brief Was the force Jacobian of this step written to the spill file?
+		bool is_gradu_h_spilled(int step) const
+		{
+			assert(step < size());
+			if (step < 0)
+				step += spill_offsets_.size();
+			return step < spill_offsets_.size() && spill_offsets_[step] >= 0;
+		}
+
+		/// @brief Read the force Jacobian of a step from the spill file (thread safe, each call opens its own stream)
+		StiffnessMatrix load_gradu_h(int step) const;
+
+		/// @brief Memory used by a sparse matrix in compressed storage
+		static double jacobian_memory(const StiffnessMatrix &mat)
+		{
+			return double(mat.nonZeros()) * (sizeof(double) + sizeof(StiffnessMatrix::StorageIndex))
+				   + double(mat.outerSize() + 1) * sizeof(StiffnessMatrix::StorageIndex);
+		}
+
 		void cache_adjoints(const Eigen::MatrixXd &adjoint_mat) { adjoint_mat_ = adjoint_mat; }
 		const Eigen::MatrixXd &adjoint_mat() const { return adjoint_mat_; }
 
@@ -107,6 +196,23 @@ namespace polyfem::solver
 			return bdf_order_(step);
 		}
 
+		/// @brief Time at which a transient step was solved
+		double time(int step) const
+		{
+			assert(step < size());
+			if (step < 0)
+				step += time_.size();
+			return time_(step);
+		}
+		/// @brief Time step size used to solve a transient step
+		double dt(int step) const
+		{
+			assert(step < size());
+			if (step < 0)
+				step += dt_.size();
+			return dt_(step);
+		}
+
         Eigen::MatrixXd disp_grad(int step = 0) const { assert(step < size()); if (step < 0) step += disp_grad_.size(); return disp_grad_[step]; }
 		
 		Eigen::VectorXd u(int step) const
@@ -138,6 +244,24 @@ namespace polyfem::solver
 				step += gradu_h_.size();
 			return gradu_h_[step];
 		}
+		/// @brief Was the force Jacobian of this step stored (otherwise it has to be recomputed)?
+		bool has_gradu_h(int step) const
+		{
+			assert(step < size());
+			if (step < 0)
+				step += gradu_h_.size();
+			return gradu_h_[step].size() > 0;
+		}
+
+		/// @brief Barrier stiffness used in the solve of a transient step
+		double barrier_stiffness(int step) const
+		{
+			assert(step < size());
+			if (step < 0)
+				step += barrier_stiffness_.size();
+			return barrier_stiffness_[step];
+		}
+
 		// const StiffnessMatrix &gradu_h_prev(const int step) const { assert(step < size()); return gradu_h_prev_[step]; }
 
 		const ipc::Collisions &collision_set(int step) const
@@ -156,6 +280,9 @@ namespace polyfem::solver
 		}
 
 	private:
+		static std::atomic<int> next_id_; // identifier of the next cache
+		const int id_;                    // identifier of this cache
+
 		int n_time_steps_ = 0;
 		int cur_size_ = 0;
 
@@ -165,10 +292,25 @@ namespace polyfem::solver
 		Eigen::MatrixXd acc_; // acceleration in transient elastic simulations
 
 		Eigen::VectorXi bdf_order_; // BDF orders used at each time step in forward simulation
+		Eigen::VectorXd time_;      // time of each step in transient simulations
+		Eigen::VectorXd dt_;        // time step size of each step in transient simulations
 
 		std::vector<StiffnessMatrix> gradu_h_; // gradient of force at time T wrt. u  at time T
 		// std::vector<StiffnessMatrix> gradu_h_prev_; // gradient of force at time T wrt. u at time (T-1) in transient simulations
 
+		double jacobian_memory_budget_ = -1; // memory budget of gradu_h_ in bytes (negative for no limit)
+		double jacobian_memory_used_ = 0;    // memory used by gradu_h_ in bytes
+		double last_jacobian_memory_ = 0;    // memory of the last assembled Jacobian, used to estimate the next one
+
+		std::vector<double> barrier_stiffness_; // barrier stiffness at each time step in transient simulations
+
+		std::string spill_path_;                    // file the force Jacobians are written to (empty to keep them in memory)
+		std::vector<std::streamoff> spill_offsets_; // offset of the Jacobian of each step in the spill file (negative if not spilled)
+		std::streamoff spill_size_ = 0;             // current size of the spill file
+
+		void init_spill_file(const int n_time_steps);
+		void spill_gradu_h(const int step, const StiffnessMatrix &gradu_h);
+
 		std::vector<ipc::Collisions> collision_set_;
 		std::vector<ipc::FrictionCollisions> friction_collision_set_;
 
@@ -0,0 +1,31 @@
+#include "ForcingTerm.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyfem::solver
+{
+	ForcingTerm::ForcingTerm(const json &args)
+		: min_eta_(args["min_forcing_term"]),
+		  max_eta_(args["max_forcing_term"]),
+		  gamma_(args["gamma"]),
+		  alpha_(args["alpha"]),
+		  eta_(max_eta_)
+	{
+	}
+
+	double ForcingTerm::update(const double residual)
+	{
+		if (prev_residual_ > 0 && residual > 0)
+		{
+			double eta = gamma_ * std::pow(residual / prev_residual_, alpha_);
+			// Safeguard against a too sudden decrease of the forcing term
+			const double safeguard = gamma_ * std::pow(eta_, alpha_);
+			if (safeguard > 0.1)
+				eta = std::max(eta, safeguard);
+			eta_ = std::clamp(eta, min_eta_, max_eta_);
+		}
+		prev_residual_ = residual;
+		return eta_;
+	}
+} // namespace polyfem::solver
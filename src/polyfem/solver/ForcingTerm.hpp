@@ -0,0 +1,29 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+namespace polyfem::solver
+{
+	/// @brief Eisenstat–Walker (choice 2) forcing term for inexact Newton
+	class ForcingTerm
+	{
+	public:
+		/// @param args Inexact Newton settings (min_forcing_term, max_forcing_term, gamma, alpha)
+		ForcingTerm(const json &args);
+
+		/// @brief Update the forcing term from the current residual norm
+		/// @param residual Norm of the gradient at the current solution
+		/// @return Relative tolerance for the next linear solves
+		double update(const double residual);
+
+		double eta() const { return eta_; }
+
+	private:
+		const double min_eta_;
+		const double max_eta_;
+		const double gamma_;
+		const double alpha_;
+		double eta_;
+		double prev_residual_ = -1;
+	};
+} // namespace polyfem::solver
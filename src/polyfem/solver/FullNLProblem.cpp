@@ -3,34 +3,100 @@
 namespace polyfem::solver
 {
 	FullNLProblem::FullNLProblem(const std::vector<std::shared_ptr<Form>> &forms)
-		: forms_(forms)
+		: forms_(forms), form_timings_(forms.size())
 	{
 	}
 
+	json FullNLProblem::FormTimings::to_json() const
+	{
+		const auto timing_to_json = [](const utils::Timing &t) {
+			return json{{"time", t.time}, {"calls", t.count}};
+		};
+
+		return json{
+			{"value", timing_to_json(value)},
+			{"gradient", timing_to_json(gradient)},
+			{"hessian", timing_to_json(hessian)},
+			{"max_step_size", timing_to_json(max_step_size)},
+			{"is_step_valid", timing_to_json(is_step_valid)},
+			{"is_step_collision_free", timing_to_json(is_step_collision_free)},
+			{"line_search_begin", timing_to_json(line_search_begin)},
+			{"solution_changed", timing_to_json(solution_changed)},
+		};
+	}
+
+	const FullNLProblem::FormTimings &FullNLProblem::form_timings(const Form &form) const
+	{
+		static const FormTimings empty;
+		for (int i = 0; i < forms_.size(); ++i)
+			if (forms_[i].get() == &form && i < form_timings_.size())
+				return form_timings_[i];
+		return empty;
+	}
+
+	void FullNLProblem::reset_form_timings()
+	{
+		form_timings_.assign(forms_.size(), FormTimings());
+	}
+
 	void FullNLProblem::init(const TVector &x)
 	{
+		if (form_timings_.size() != forms_.size())
+			form_timings_.resize(forms_.size());
+		invalidate_last_hessian();
 		for (auto &f : forms_)
 			f->init(x);
 	}
 
 	void FullNLProblem::set_project_to_psd(bool project_to_psd)
 	{
+		project_to_psd_ = project_to_psd;
 		for (auto &f : forms_)
 			f->set_project_to_psd(project_to_psd);
 	}
 
 	void FullNLProblem::init_lagging(const TVector &x)
 	{
+		invalidate_last_hessian();
 		for (auto &f : forms_)
 			f->init_lagging(x);
 	}
 
 	void FullNLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
+		invalidate_last_hessian();
 		for (auto &f : forms_)
 			f->update_lagging(x, iter_num);
 	}
 
+	void FullNLProblem::set_keep_last_hessian(const bool val)
+	{
+		keep_last_hessian_ = val;
+		invalidate_last_hessian();
+	}
+
+	FullNLProblem::TVector FullNLProblem::form_weights() const
+	{
+		TVector weights(forms_.size());
+		for (int i = 0; i < forms_.size(); ++i)
+			weights[i] = forms_[i]->enabled() ? forms_[i]->weight() : 0;
+		return weights;
+	}
+
+	bool FullNLProblem::last_hessian(const TVector &x, const double tolerance, THessian &hessian) const
+	{
+		if (last_hessian_.size() == 0 || last_hessian_x_.size() != x.size())
+			return false;
+		// The weights include the time step scaling, barrier stiffness, and AL weights
+		if (form_weights() != last_hessian_weights_)
+			return false;
+		if ((x - last_hessian_x_).lpNorm<Eigen::Infinity>() > tolerance)
+			return false;
+
+		hessian = last_hessian_;
+		return true;
+	}
+
 	int FullNLProblem::max_lagging_iterations() const
 	{
 		int max_lagging_iterations = 1;
@@ -49,8 +115,11 @@ namespace polyfem::solver
 
 	void FullNLProblem::line_search_begin(const TVector &x0, const TVector &x1)
 	{
-		for (auto &f : forms_)
-			f->line_search_begin(x0, x1);
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			POLYFEM_SCOPED_TIMER(form_timings_[i].line_search_begin);
+			forms_[i]->line_search_begin(x0, x1);
+		}
 	}
 
 	void FullNLProblem::line_search_end()
@@ -62,46 +131,66 @@ namespace polyfem::solver
 	double FullNLProblem::max_step_size(const TVector &x0, const TVector &x1)
 	{
 		double step = 1;
-		for (auto &f : forms_)
-			if (f->enabled())
-				step = std::min(step, f->max_step_size(x0, x1));
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			if (!forms_[i]->enabled())
+				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].max_step_size);
+			step = std::min(step, forms_[i]->max_step_size(x0, x1));
+		}
+		min_max_step_size_ = std::min(min_max_step_size_, step);
 		return step;
 	}
 
 	bool FullNLProblem::is_step_valid(const TVector &x0, const TVector &x1)
 	{
-		for (auto &f : forms_)
-			if (f->enabled() && !f->is_step_valid(x0, x1))
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			if (!forms_[i]->enabled())
+				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].is_step_valid);
+			if (!forms_[i]->is_step_valid(x0, x1))
 				return false;
+		}
 		return true;
 	}
 
 	bool FullNLProblem::is_step_collision_free(const TVector &x0, const TVector &x1)
 	{
-		for (auto &f : forms_)
-			if (f->enabled() && !f->is_step_collision_free(x0, x1))
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			if (!forms_[i]->enabled())
+				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].is_step_collision_free);
+			if (!forms_[i]->is_step_collision_free(x0, x1))
 				return false;
+		}
 		return true;
 	}
 
 	double FullNLProblem::value(const TVector &x)
 	{
 		double val = 0;
-		for (auto &f : forms_)
-			if (f->enabled())
-				val += f->value(x);
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			if (!forms_[i]->enabled())
+				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].value);
+			val += forms_[i]->value(x);
+		}
 		return val;
 	}
 
 	void FullNLProblem::gradient(const TVector &x, TVector &grad)
 	{
 		grad = TVector::Zero(x.size());
-		for (auto &f : forms_)
+		for (int i = 0; i < forms_.size(); ++i)
 		{
-			if (!f->enabled())
+			if (!forms_[i]->enabled())
 				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].gradient);
 			TVector tmp;
-			f->first_derivative(x, tmp);
+			forms_[i]->first_derivative(x, tmp);
 			grad += tmp;
 		}
 	}
@@ -109,20 +198,32 @@ namespace polyfem::solver
 	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
 	{
 		hessian.resize(x.size(), x.size());
-		for (auto &f : forms_)
+		for (int i = 0; i < forms_.size(); ++i)
 		{
-			if (!f->enabled())
+			if (!forms_[i]->enabled())
 				continue;
+			POLYFEM_SCOPED_TIMER(form_timings_[i].hessian);
 			THessian tmp;
-			f->second_derivative(x, tmp);
+			forms_[i]->second_derivative(x, tmp);
 			hessian += tmp;
 		}
+
+		// A Hessian projected to PSD is not the force Jacobian, do not pay for the copy
+		if (keep_last_hessian_ && !project_to_psd_)
+		{
+			last_hessian_ = hessian;
+			last_hessian_x_ = x;
+			last_hessian_weights_ = form_weights();
+		}
 	}
 
 	void FullNLProblem::solution_changed(const TVector &x)
 	{
-		for (auto &f : forms_)
-			f->solution_changed(x);
+		for (int i = 0; i < forms_.size(); ++i)
+		{
+			POLYFEM_SCOPED_TIMER(form_timings_[i].solution_changed);
+			forms_[i]->solution_changed(x);
+		}
 	}
 
 	void FullNLProblem::post_step(const polysolve::nonlinear::PostStepData &data)
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <polyfem/solver/forms/Form.hpp>
+#include <polyfem/utils/Timer.hpp>
+#include <polyfem/Common.hpp>
 #include <polysolve/nonlinear/Problem.hpp>
 
 #include <memory>
@@ -11,6 +13,22 @@ namespace polyfem::solver
 	class FullNLProblem : public polysolve::nonlinear::Problem
 	{
 	public:
+		/// @brief Accumulated wall time and number of calls of each form operation
+		struct FormTimings
+		{
+			utils::Timing value;
+			utils::Timing gradient;
+			utils::Timing hessian;
+			utils::Timing max_step_size;
+			utils::Timing is_step_valid;
+			utils::Timing is_step_collision_free;
+			utils::Timing line_search_begin;
+			utils::Timing solution_changed;
+
+			/// @brief Export the timings as {operation: {"time": seconds, "calls": count}}
+			json to_json() const;
+		};
+
 		FullNLProblem(const std::vector<std::shared_ptr<Form>> &forms);
 		virtual ~FullNLProblem() = default;
 		virtual void init(const TVector &x0) override;
@@ -38,6 +56,31 @@ namespace polyfem::solver
 
 		std::vector<std::shared_ptr<Form>> &forms() { return forms_; }
 
+		/// @brief Get the timings accumulated for a form since the last reset
+		/// @param form Form of this problem
+		/// @return Timings of the form (all zeros if the form is not part of this problem)
+		const FormTimings &form_timings(const Form &form) const;
+
+		/// @brief Reset the timings of all forms (e.g., at the beginning of a time step)
+		void reset_form_timings();
+
+		/// @brief Smallest step size returned by max_step_size since the last reset (1 if no step was limited)
+		double min_max_step_size() const { return min_max_step_size_; }
+
+		/// @brief Reset the smallest step size returned by max_step_size
+		void reset_min_max_step_size() { min_max_step_size_ = 1; }
+
+		/// @brief Keep a copy of the last Hessian assembled without PSD projection (e.g., to reuse it as the force Jacobian of the adjoint)
+		/// @param val True to keep the last Hessian
+		void set_keep_last_hessian(const bool val);
+
+		/// @brief Get the last assembled Hessian if it is the Hessian of the current forms at x without PSD projection
+		/// @param[in] x Full solution
+		/// @param[in] tolerance Largest distance (infinity norm) between x and the solution the Hessian was assembled at
+		/// @param[out] hessian Last assembled Hessian
+		/// @return True if the last Hessian can be used at x
+		bool last_hessian(const TVector &x, const double tolerance, THessian &hessian) const;
+
 		virtual bool stop(const TVector &x) override { return false; }
 
 		void finish()
@@ -48,5 +91,23 @@ namespace polyfem::solver
 
 	protected:
 		std::vector<std::shared_ptr<Form>> forms_;
+
+		/// @brief Timings of each form, parallel to forms_
+		std::vector<FormTimings> form_timings_;
+
+		/// @brief Smallest step size returned by max_step_size since the last reset
+		double min_max_step_size_ = 1;
+
+		/// @brief Drop the last Hessian, the forms changed since it was assembled
+		void invalidate_last_hessian() { last_hessian_.resize(0, 0); }
+
+		bool keep_last_hessian_ = false; ///< Keep a copy of the last Hessian assembled without PSD projection
+		bool project_to_psd_ = false;    ///< Are the form Hessians projected to PSD?
+		THessian last_hessian_;          ///< Last unprojected Hessian (empty if unknown or outdated)
+		TVector last_hessian_x_;         ///< Solution last_hessian_ was assembled at
+		TVector last_hessian_weights_;   ///< Weight of each form when last_hessian_ was assembled (zero if disabled)
+
+		/// @brief Weight of each form (zero if disabled)
+		TVector form_weights() const;
 	};
 } // namespace polyfem::solver
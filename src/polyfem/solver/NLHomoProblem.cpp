@@ -353,6 +353,12 @@ namespace polyfem::solver
         for (auto &form : homo_forms)
             form->line_search_begin(reduced_to_extended(x0), reduced_to_extended(x1));
     }
+    void NLHomoProblem::line_search_end()
+    {
+        NLProblem::line_search_end();
+        for (auto &form : homo_forms)
+            form->line_search_end();
+    }
     void NLHomoProblem::post_step(const polysolve::nonlinear::PostStepData &data)
     {
         NLProblem::post_step(data);
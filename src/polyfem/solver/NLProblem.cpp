@@ -1,6 +1,7 @@
 #include "NLProblem.hpp"
 
 #include <polyfem/io/OBJWriter.hpp>
+#include <polyfem/utils/HashUtils.hpp>
 
 /*
 m \frac{\partial^2 u}{\partial t^2} = \psi = \text{div}(\sigma[u])\newline
@@ -59,19 +60,86 @@ namespace polyfem::solver
 		use_reduced_size();
 	}
 
+	void NLProblem::init(const TVector &x0)
+	{
+		prev_grad_norm_ = -1;
+		FullNLProblem::init(x0);
+	}
+
 	void NLProblem::init_lagging(const TVector &x)
 	{
+		invalidate_hessian_cache();
 		FullNLProblem::init_lagging(reduced_to_full(x));
 	}
 
 	void NLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
+		invalidate_hessian_cache();
 		FullNLProblem::update_lagging(reduced_to_full(x), iter_num);
 	}
 
+	void NLProblem::set_project_to_psd(bool val)
+	{
+		invalidate_hessian_cache();
+		FullNLProblem::set_project_to_psd(val);
+	}
+
+	void NLProblem::set_hessian_reuse(const int max_reuse, const double min_convergence_rate)
+	{
+		max_hessian_reuse_ = std::max(max_reuse, 0);
+		min_convergence_rate_ = min_convergence_rate;
+		invalidate_hessian_cache();
+	}
+
+	void NLProblem::invalidate_hessian_cache()
+	{
+		cached_hessian_.resize(0, 0);
+		consecutive_hessian_reuses_ = 0;
+		force_hessian_assembly_ = true;
+	}
+
+	void NLProblem::reset_hessian_reuse_info()
+	{
+		n_hessian_assemblies_ = 0;
+		n_hessian_reuses_ = 0;
+	}
+
+	json NLProblem::hessian_reuse_info() const
+	{
+		return {
+			{"assemblies", n_hessian_assemblies_},
+			{"reuses", n_hessian_reuses_},
+		};
+	}
+
+	size_t NLProblem::hessian_state_hash() const
+	{
+		size_t hash = current_size();
+		for (const auto &f : forms_)
+		{
+			utils::hash_combine(hash, f->enabled());
+			if (!f->enabled())
+				continue;
+			utils::hash_combine(hash, std::hash<double>()(f->weight()));
+			utils::hash_combine(hash, f->is_project_to_psd());
+			utils::hash_combine(hash, f->hessian_state_hash());
+		}
+		return hash;
+	}
+
+	bool NLProblem::can_reuse_hessian() const
+	{
+		return max_hessian_reuse_ > 0
+			   && !force_hessian_assembly_
+			   && consecutive_hessian_reuses_ < max_hessian_reuse_
+			   && cached_hessian_.rows() == current_size()
+			   && cached_hessian_hash_ == hessian_state_hash();
+	}
+
 	void NLProblem::update_quantities(const double t, const TVector &x)
 	{
 		t_ = t;
+		invalidate_last_hessian();
 		const TVector full = reduced_to_full(x);
 		for (auto &f : forms_)
 			f->update_quantities(t, full);
@@ -112,10 +180,27 @@ namespace polyfem::solver
 
 	void NLProblem::hessian(const TVector &x, THessian &hessian)
 	{
+		if (can_reuse_hessian())
+		{
+			hessian = cached_hessian_;
+			++consecutive_hessian_reuses_;
+			++n_hessian_reuses_;
+			return;
+		}
+
 		THessian full_hessian;
 		FullNLProblem::hessian(reduced_to_full(x), full_hessian);
 
 		full_hessian_to_reduced_hessian(full_hessian, hessian);
+		++n_hessian_assemblies_;
+
+		if (max_hessian_reuse_ > 0)
+		{
+			cached_hessian_ = hessian;
+			cached_hessian_hash_ = hessian_state_hash();
+			consecutive_hessian_reuses_ = 0;
+			force_hessian_assembly_ = false;
+		}
 	}
 
 	void NLProblem::solution_changed(const TVector &newX)
@@ -127,6 +212,15 @@ namespace polyfem::solver
 	{
 		FullNLProblem::post_step(polysolve::nonlinear::PostStepData(data.iter_num, data.solver_info, reduced_to_full(data.x), reduced_to_full(data.grad)));
 
+		if (max_hessian_reuse_ > 0)
+		{
+			// Reassemble the Hessian once the reused one stops making enough progress
+			const double grad_norm = data.grad.norm();
+			if (prev_grad_norm_ > 0 && 1 - grad_norm / prev_grad_norm_ < min_convergence_rate_)
+				force_hessian_assembly_ = true;
+			prev_grad_norm_ = grad_norm;
+		}
+
 		// TODO: add me back
 		// if (state_.args["output"]["advanced"]["save_nl_solve_sequence"])
 		// {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <polyfem/Common.hpp>
 #include <polyfem/solver/FullNLProblem.hpp>
 #include <polyfem/assembler/RhsAssembler.hpp>
 #include <polyfem/mesh/LocalBoundary.hpp>
@@ -31,6 +32,8 @@ namespace polyfem::solver
 				  const std::vector<std::shared_ptr<Form>> &forms);
 		virtual ~NLProblem() = default;
 
+		void init(const TVector &x0) override;
+
 		virtual double value(const TVector &x) override;
 		virtual void gradient(const TVector &x, TVector &gradv) override;
 		virtual void hessian(const TVector &x, THessian &hessian) override;
@@ -46,8 +49,22 @@ namespace polyfem::solver
 		void init_lagging(const TVector &x) override;
 		void update_lagging(const TVector &x, const int iter_num) override;
 
+		void set_project_to_psd(bool val) override;
+
 		// --------------------------------------------------------------------
 
+		/// @brief Reuse the last assembled Hessian in later Newton iterations
+		/// @param max_reuse Maximum number of consecutive iterations reusing the same Hessian (0 disables reuse)
+		/// @param min_convergence_rate Reassemble once the relative gradient norm decrease (1 - |g_k|/|g_k-1|) drops below this value
+		void set_hessian_reuse(const int max_reuse, const double min_convergence_rate);
+		bool uses_hessian_reuse() const { return max_hessian_reuse_ > 0; }
+		/// @brief Drop the cached Hessian so that the next call to hessian() assembles it
+		void invalidate_hessian_cache();
+		/// @brief Number of Hessian assemblies and reuses since the last call to reset_hessian_reuse_info()
+		json hessian_reuse_info() const;
+		/// @brief Restart the Hessian assembly and reuse counts (e.g., at the start of a subsolve)
+		void reset_hessian_reuse_info();
+
 		virtual void update_quantities(const double t, const TVector &x);
 
 		int full_size() const { return full_size_; }
@@ -88,6 +105,20 @@ namespace polyfem::solver
 		double t_;
 
 	private:
+		/// @brief Combined hash of the form weights and discrete states the Hessian depends on
+		size_t hessian_state_hash() const;
+		bool can_reuse_hessian() const;
+
+		int max_hessian_reuse_ = 0;              ///< Maximum number of consecutive reuses of the cached Hessian
+		double min_convergence_rate_ = 0;        ///< Reassemble when the gradient norm decreases slower than this rate
+		THessian cached_hessian_;                ///< Last assembled (reduced) Hessian
+		size_t cached_hessian_hash_ = 0;         ///< State hash when cached_hessian_ was assembled
+		int consecutive_hessian_reuses_ = 0;     ///< Number of times cached_hessian_ has been reused
+		bool force_hessian_assembly_ = true;     ///< Set when the convergence rate dropped
+		double prev_grad_norm_ = -1;             ///< Gradient norm at the previous iteration
+		int n_hessian_assemblies_ = 0;           ///< Statistics: number of assembled Hessians
+		int n_hessian_reuses_ = 0;               ///< Statistics: number of reused Hessians
+
 		const assembler::RhsAssembler *rhs_assembler_;
 		const std::vector<mesh::LocalBoundary> *local_boundary_;
 		const int n_boundary_samples_;
@@ -335,4 +335,18 @@ namespace polyfem::solver
 			{"periodic_contact", periodic_contact_form},
 		};
 	}
+
+	json SolveData::form_timings() const
+	{
+		json timings = json::object();
+		if (!nl_problem)
+			return timings;
+
+		for (const auto &[name, form] : named_forms())
+		{
+			if (form)
+				timings[name] = nl_problem->form_timings(*form).to_json();
+		}
+		return timings;
+	}
 } // namespace polyfem::solver
@@ -138,6 +138,10 @@ namespace polyfem::solver
 
 		std::vector<std::pair<std::string, std::shared_ptr<solver::Form>>> named_forms() const;
 
+		/// @brief Timings and call counts of the forms accumulated by the nonlinear problem since the last reset
+		/// @return {form name: {operation: {"time": seconds, "calls": count}}}, only for existing forms
+		json form_timings() const;
+
 	public:
 		std::shared_ptr<assembler::RhsAssembler> rhs_assembler;
 		std::shared_ptr<assembler::PressureAssembler> pressure_assembler;
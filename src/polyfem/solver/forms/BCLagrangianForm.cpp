@@ -1,5 +1,6 @@
 #include "BCLagrangianForm.hpp"
 
+#include <polyfem/io/Snapshot.hpp>
 #include <polyfem/utils/Logger.hpp>
 
 namespace polyfem::solver
@@ -127,12 +128,24 @@ namespace polyfem::solver
 		hessian.setZero();
 	}
 
-	void BCLagrangianForm::update_quantities(const double t, const Eigen::VectorXd &)
+	void BCLagrangianForm::update_quantities(const double t, const Eigen::VectorXd &x)
 	{
 		if (is_time_dependent_)
 			update_target(t);
 	}
 
+	void BCLagrangianForm::accept_step(const Eigen::VectorXd &x)
+	{
+		if (x.size() == lagr_mults_.size())
+		{
+			x_prev_prev_ = x_prev_;
+			x_prev_ = x;
+		}
+		prev_converged_lagr_mults_ = converged_lagr_mults_;
+		converged_lagr_mults_ = lagr_mults_;
+		lagr_mults_extrapolated_ = false;
+	}
+
 	void BCLagrangianForm::update_target(const double t)
 	{
 		assert(rhs_assembler_ != nullptr);
@@ -148,4 +161,46 @@ namespace polyfem::solver
 	{
 		lagr_mults_ -= k_al * masked_lumped_mass_sqrt_ * (x - target_x_);
 	}
+
+	Eigen::VectorXd BCLagrangianForm::predicted_solution() const
+	{
+		if (x_prev_.size() == 0 || x_prev_prev_.size() != x_prev_.size())
+			return Eigen::VectorXd();
+		return 2 * x_prev_ - x_prev_prev_;
+	}
+
+	void BCLagrangianForm::extrapolate_lagrangian()
+	{
+		if (lagr_mults_extrapolated_ || prev_converged_lagr_mults_.size() != lagr_mults_.size())
+			return;
+		lagr_mults_ += converged_lagr_mults_ - prev_converged_lagr_mults_;
+		lagr_mults_extrapolated_ = true;
+	}
+
+	void BCLagrangianForm::save_snapshot(io::Snapshot &snapshot) const
+	{
+		const std::string prefix = name() + "/";
+		snapshot.set(prefix + "lagr_mults", lagr_mults_);
+		snapshot.set(prefix + "x_prev", x_prev_);
+		snapshot.set(prefix + "x_prev_prev", x_prev_prev_);
+		snapshot.set(prefix + "converged_lagr_mults", converged_lagr_mults_);
+		snapshot.set(prefix + "prev_converged_lagr_mults", prev_converged_lagr_mults_);
+		snapshot.set(prefix + "lagr_mults_extrapolated", double(lagr_mults_extrapolated_));
+		snapshot.set(prefix + "last_al_weight", last_al_weight_);
+	}
+
+	void BCLagrangianForm::load_snapshot(const io::Snapshot &snapshot)
+	{
+		const std::string prefix = name() + "/";
+		if (snapshot.get(prefix + "lagr_mults").size() != lagr_mults_.size())
+			log_and_throw_error("Snapshot has {} lagrange multipliers, expected {}", snapshot.get(prefix + "lagr_mults").size(), lagr_mults_.size());
+
+		lagr_mults_ = snapshot.get(prefix + "lagr_mults");
+		x_prev_ = snapshot.get(prefix + "x_prev");
+		x_prev_prev_ = snapshot.get(prefix + "x_prev_prev");
+		converged_lagr_mults_ = snapshot.get(prefix + "converged_lagr_mults");
+		prev_converged_lagr_mults_ = snapshot.get(prefix + "prev_converged_lagr_mults");
+		lagr_mults_extrapolated_ = snapshot.get_scalar(prefix + "lagr_mults_extrapolated") != 0;
+		last_al_weight_ = snapshot.get_scalar(prefix + "last_al_weight");
+	}
 } // namespace polyfem::solver
@@ -71,6 +71,33 @@ namespace polyfem::solver
 
 		void update_lagrangian(const Eigen::VectorXd &x, const double k_al);
 
+		/// @brief Record an accepted time step in the warm start history
+		/// @param x Solution of the accepted time step
+		void accept_step(const Eigen::VectorXd &x);
+
+		/// @brief Current lagrange multipliers
+		const Eigen::VectorXd &lagrange_multipliers() const { return lagr_mults_; }
+		void set_lagrange_multipliers(const Eigen::VectorXd &lagr_mults) { lagr_mults_ = lagr_mults; }
+
+		/// @brief Linear extrapolation of the last two accepted solutions
+		/// @return Predicted solution, empty if not enough history is available
+		Eigen::VectorXd predicted_solution() const;
+
+		/// @brief Extrapolate the lagrange multipliers from the last two time steps (at most once per time step)
+		void extrapolate_lagrangian();
+
+		/// @brief Weight of the last augmented lagrangian solve (zero if none)
+		double last_al_weight() const { return last_al_weight_; }
+		void set_last_al_weight(const double al_weight) { last_al_weight_ = al_weight; }
+
+		/// @brief Store the lagrange multipliers, their warm start history, and the weight of the last augmented lagrangian solve
+		/// @param snapshot Snapshot to write into
+		void save_snapshot(io::Snapshot &snapshot) const override;
+
+		/// @brief Restore the lagrange multipliers, their warm start history, and the weight of the last augmented lagrangian solve
+		/// @param snapshot Snapshot to read from
+		void load_snapshot(const io::Snapshot &snapshot) override;
+
 	private:
 		const std::vector<int> &boundary_nodes_;
 		const std::vector<mesh::LocalBoundary> *local_boundary_;
@@ -84,6 +111,13 @@ namespace polyfem::solver
 		Eigen::MatrixXd target_x_;                ///< actually a vector with the same size as x with target nodal positions
 		Eigen::VectorXd lagr_mults_;              ///< vector of lagrange multipliers
 
+		// Warm start of the augmented lagrangian across time steps
+		Eigen::VectorXd x_prev_, x_prev_prev_;      ///< last two accepted solutions
+		Eigen::VectorXd converged_lagr_mults_;      ///< lagrange multipliers at the end of the last time step
+		Eigen::VectorXd prev_converged_lagr_mults_; ///< lagrange multipliers at the end of the time step before
+		bool lagr_mults_extrapolated_ = false;
+		double last_al_weight_ = 0;
+
 		/// @brief Initialize the masked lumped mass matrix
 		/// @param ndof Number of degrees of freedom
 		/// @param mass Mass matrix
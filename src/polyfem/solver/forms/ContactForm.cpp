@@ -7,16 +7,93 @@
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
 #include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/HashUtils.hpp>
 
 #include <polyfem/io/OBJWriter.hpp>
+#include <polyfem/io/Snapshot.hpp>
 
 #include <ipc/barrier/adaptive_stiffness.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
+#include <ipc/utils/intersection.hpp>
+#include <ipc/barrier/barrier.hpp>
 
 #include <igl/writePLY.h>
+#include <igl/predicates/segment_segment_intersect.h>
+
+#include <limits>
+#include <unordered_map>
 
 namespace polyfem::solver
 {
+#ifndef NDEBUG
+	namespace
+	{
+		/// @brief Pairs of primitives that can intersect along a motion (edge-edge in 2D, edge-face in 3D)
+		struct IntersectionCandidates
+		{
+			std::vector<ipc::EdgeEdgeCandidate> ee_candidates;
+			std::vector<ipc::EdgeFaceCandidate> ef_candidates;
+		};
+
+		IntersectionCandidates build_intersection_candidates(
+			const ipc::CollisionMesh &mesh,
+			const Eigen::MatrixXd &V0,
+			const Eigen::MatrixXd &V1,
+			const ipc::BroadPhaseMethod method)
+		{
+			std::shared_ptr<ipc::BroadPhase> broad_phase = ipc::BroadPhase::make_broad_phase(method);
+			broad_phase->can_vertices_collide = mesh.can_collide;
+			broad_phase->build(V0, V1, mesh.edges(), mesh.faces());
+
+			IntersectionCandidates candidates;
+			if (V0.cols() == 2)
+				broad_phase->detect_edge_edge_candidates(candidates.ee_candidates);
+			else
+				broad_phase->detect_edge_face_candidates(candidates.ef_candidates);
+			return candidates;
+		}
+
+		/// @brief Check for static intersections among the candidates (narrow phase only, in parallel)
+		bool has_intersections(
+			const ipc::CollisionMesh &mesh,
+			const IntersectionCandidates &candidates,
+			const Eigen::MatrixXd &V)
+		{
+			const Eigen::MatrixXi &E = mesh.edges();
+			const Eigen::MatrixXi &F = mesh.faces();
+			const bool is_2d = V.cols() == 2;
+			const int n = is_2d ? candidates.ee_candidates.size() : candidates.ef_candidates.size();
+
+			auto storage = utils::create_thread_storage<int>(0);
+			utils::maybe_parallel_for(n, [&](int start, int end, int thread_id) {
+				int &found = utils::get_local_thread_storage(storage, thread_id);
+				for (int i = start; i < end && !found; ++i)
+				{
+					if (is_2d)
+					{
+						const ipc::EdgeEdgeCandidate &c = candidates.ee_candidates[i];
+						found = igl::predicates::segment_segment_intersect(
+							V.row(E(c.edge0_id, 0)), V.row(E(c.edge0_id, 1)),
+							V.row(E(c.edge1_id, 0)), V.row(E(c.edge1_id, 1)));
+					}
+					else
+					{
+						const ipc::EdgeFaceCandidate &c = candidates.ef_candidates[i];
+						found = ipc::is_edge_intersecting_triangle(
+							V.row(E(c.edge_id, 0)), V.row(E(c.edge_id, 1)),
+							V.row(F(c.face_id, 0)), V.row(F(c.face_id, 1)), V.row(F(c.face_id, 2)));
+					}
+				}
+			});
+
+			for (const int found : storage)
+				if (found)
+					return true;
+			return false;
+		}
+	} // namespace
+#endif
+
 	ContactForm::ContactForm(const ipc::CollisionMesh &collision_mesh,
 							 const double dhat,
 							 const double avg_mass,
@@ -48,7 +125,7 @@ namespace polyfem::solver
 
 	void ContactForm::init(const Eigen::VectorXd &x)
 	{
-		update_collision_set(compute_displaced_surface(x));
+		update_collision_set(x);
 	}
 
 	void ContactForm::force_shape_derivative(const ipc::Collisions &collision_set, const Eigen::MatrixXd &solution, const Eigen::VectorXd &adjoint_sol, Eigen::VectorXd &term)
@@ -63,7 +140,49 @@ namespace polyfem::solver
 
 	void ContactForm::update_quantities(const double t, const Eigen::VectorXd &x)
 	{
-		update_collision_set(compute_displaced_surface(x));
+		update_collision_set(x);
+		build_hessian_pattern(x);
+	}
+
+	void ContactForm::set_persistent_hessian_pattern(const double inflation)
+	{
+		hessian_pattern_inflation_ = inflation;
+		hessian_pattern_.resize(0, 0);
+	}
+
+	void ContactForm::build_hessian_pattern(const Eigen::VectorXd &x) const
+	{
+		if (hessian_pattern_inflation_ < 0)
+			return;
+
+		POLYFEM_SCOPED_TIMER("contact hessian pattern");
+
+		const Eigen::MatrixXd V = compute_displaced_surface(x);
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+		const int dim = collision_mesh_.dim();
+
+		ipc::Candidates candidates;
+		candidates.build(
+			collision_mesh_, V,
+			/*inflation_radius=*/(1 + hessian_pattern_inflation_) * dhat_ / 2,
+			broad_phase_method_);
+
+		std::vector<Eigen::Triplet<double>> entries;
+		for (size_t i = 0; i < candidates.size(); ++i)
+		{
+			const int n_v = candidates[i].num_vertices();
+			const std::array<long, 4> vis = candidates[i].vertex_ids(E, F);
+			for (int a = 0; a < n_v; ++a)
+				for (int b = 0; b < n_v; ++b)
+					for (int d0 = 0; d0 < dim; ++d0)
+						for (int d1 = 0; d1 < dim; ++d1)
+							entries.emplace_back(vis[a] * dim + d0, vis[b] * dim + d1, 0.0);
+		}
+
+		StiffnessMatrix pattern(V.size(), V.size());
+		pattern.setFromTriplets(entries.begin(), entries.end());
+		hessian_pattern_ = collision_mesh_.to_full_dof(pattern);
 	}
 
 	Eigen::MatrixXd ContactForm::compute_displaced_surface(const Eigen::VectorXd &x) const
@@ -87,6 +206,8 @@ namespace polyfem::solver
 			collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
 		Eigen::VectorXd grad_barrier = barrier_potential_.gradient(
 			nonconvergent_constraints, collision_mesh_, displaced_surface);
+		if (!planes_.empty())
+			grad_barrier += plane_gradient(displaced_surface, /*area_weighted=*/false);
 		grad_barrier = collision_mesh_.to_full_dof(grad_barrier);
 
 		barrier_stiffness_ = ipc::initial_barrier_stiffness(
@@ -96,14 +217,17 @@ namespace polyfem::solver
 		if (use_convergent_formulation())
 		{
 			double scaling_factor = 0;
-			if (!nonconvergent_constraints.empty())
+			const double nonconvergent_plane_potential = planes_.empty() ? 0 : plane_potentials(displaced_surface, /*area_weighted=*/false).sum();
+			if (!nonconvergent_constraints.empty() || nonconvergent_plane_potential > 0)
 			{
 				const double nonconvergent_potential = barrier_potential_(
-					nonconvergent_constraints, collision_mesh_, displaced_surface);
+					nonconvergent_constraints, collision_mesh_, displaced_surface) + nonconvergent_plane_potential;
 
-				update_collision_set(displaced_surface);
-				const double convergent_potential = barrier_potential_(
+				update_collision_set(x);
+				double convergent_potential = barrier_potential_(
 					collision_set_, collision_mesh_, displaced_surface);
+				if (!planes_.empty())
+					convergent_potential += plane_potentials(displaced_surface).sum();
 
 				scaling_factor = nonconvergent_potential / convergent_potential;
 			}
@@ -126,25 +250,218 @@ namespace polyfem::solver
 			barrier_stiffness(), max_barrier_stiffness_);
 	}
 
-	void ContactForm::update_collision_set(const Eigen::MatrixXd &displaced_surface)
+	void ContactForm::update_collision_set(const Eigen::VectorXd &x)
 	{
-		// Store the previous value used to compute the constraint set to avoid duplicate computation.
-		static Eigen::MatrixXd cached_displaced_surface;
-		if (cached_displaced_surface.size() == displaced_surface.size() && cached_displaced_surface == displaced_surface)
+		// Store the hash of the solution used to compute the constraint set to avoid duplicate computation.
+		const size_t x_hash = utils::HashMatrix()(x);
+		if (is_collision_set_x_hash_valid_ && x_hash == collision_set_x_hash_)
 			return;
 
-		if (use_cached_candidates_)
+		update_collision_set(compute_displaced_surface(x));
+		collision_set_x_hash_ = x_hash;
+		is_collision_set_x_hash_valid_ = true;
+	}
+
+	void ContactForm::update_collision_set(const Eigen::MatrixXd &displaced_surface)
+	{
+		if (use_cached_candidates_ || are_candidates_valid(displaced_surface, displaced_surface))
 			collision_set_.build(
 				candidates_, collision_mesh_, displaced_surface, dhat_);
+		else if (use_body_culling())
+		{
+			ipc::Candidates candidates;
+			build_body_culled_candidates(
+				displaced_surface, displaced_surface, /*inflation_radius=*/(dhat_ + dmin_) / 2, candidates);
+			collision_set_.build(candidates, collision_mesh_, displaced_surface, dhat_);
+		}
 		else
 			collision_set_.build(
 				collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
-		cached_displaced_surface = displaced_surface;
+		is_collision_set_x_hash_valid_ = false;
+
+		collision_set_hash_ = hash_collision_set(collision_set_, collision_mesh_);
+		if (!planes_.empty())
+			utils::hash_combine(collision_set_hash_, hash_plane_contacts(displaced_surface));
+	}
+
+	size_t ContactForm::hash_collision_set(const ipc::Collisions &collision_set, const ipc::CollisionMesh &collision_mesh)
+	{
+		const Eigen::MatrixXi &E = collision_mesh.edges();
+		const Eigen::MatrixXi &F = collision_mesh.faces();
+		size_t hash = collision_set.size();
+		for (size_t i = 0; i < collision_set.size(); i++)
+		{
+			for (const long vi : collision_set[i].vertex_ids(E, F))
+				utils::hash_combine(hash, std::hash<long>()(vi));
+		}
+		return hash;
+	}
+
+	bool ContactForm::is_collision_set_built_for(const Eigen::VectorXd &x) const
+	{
+		return is_collision_set_x_hash_valid_ && utils::HashMatrix()(x) == collision_set_x_hash_;
 	}
 
 	double ContactForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
-		return barrier_potential_(collision_set_, collision_mesh_, compute_displaced_surface(x));
+		const Eigen::MatrixXd V = compute_displaced_surface(x);
+		double value = barrier_potential_(collision_set_, collision_mesh_, V);
+		if (!planes_.empty())
+			value += plane_potentials(V).sum();
+		return value;
+	}
+
+	void ContactForm::set_planes(const std::vector<mesh::Obstacle::Plane> &planes, const int n_obstacle_vertices)
+	{
+		planes_ = planes;
+
+		// The obstacle vertices are at the end of the full collision mesh
+		const int n_fe_vertices = collision_mesh_.full_num_vertices() - n_obstacle_vertices;
+		std::vector<int> ids;
+		for (int i = 0; i < collision_mesh_.num_vertices(); i++)
+			if (collision_mesh_.to_full_vertex_id(i) < n_fe_vertices)
+				ids.push_back(i);
+		plane_vertex_ids_ = Eigen::Map<Eigen::VectorXi>(ids.data(), ids.size());
+
+		// Same area weighting and scaling by dhat as the convergent formulation of barrier_potential_
+		plane_weights_.setOnes(ids.size());
+		if (use_convergent_formulation())
+		{
+			for (int i = 0; i < ids.size(); i++)
+				plane_weights_[i] = collision_mesh_.vertex_area(ids[i]) / (dhat_ * std::pow(dhat_ + 2 * dmin_, 2));
+		}
+	}
+
+	Eigen::VectorXd ContactForm::plane_potentials(const Eigen::MatrixXd &V, const bool area_weighted) const
+	{
+		// The barrier is a function of the squared distance, as in the ipc barrier potential
+		Eigen::VectorXd potentials = Eigen::VectorXd::Zero(V.rows());
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::VectorXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			for (int i = 0; i < d.size(); i++)
+			{
+				// Vertices behind the plane are not in contact with it
+				if (d[i] > 0 && d[i] < dhat_)
+					potentials[plane_vertex_ids_[i]] += (area_weighted ? plane_weights_[i] : 1.0) * ipc::barrier(d[i] * d[i], dhat_ * dhat_);
+			}
+		}
+		return potentials;
+	}
+
+	Eigen::VectorXd ContactForm::plane_gradient(const Eigen::MatrixXd &V, const bool area_weighted) const
+	{
+		const int dim = V.cols();
+		Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::VectorXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			for (int i = 0; i < d.size(); i++)
+			{
+				if (d[i] <= 0 || d[i] >= dhat_)
+					continue;
+				// ∇b(d²) = b'(d²) 2d n
+				const double db = ipc::barrier_first_derivative(d[i] * d[i], dhat_ * dhat_) * 2 * d[i];
+				grad.segment(plane_vertex_ids_[i] * dim, dim) += (area_weighted ? plane_weights_[i] : 1.0) * db * plane.normal();
+			}
+		}
+		return grad;
+	}
+
+	StiffnessMatrix ContactForm::plane_hessian(const Eigen::MatrixXd &V) const
+	{
+		const int dim = V.cols();
+		std::vector<Eigen::Triplet<double>> entries;
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const MatrixNd nnT = plane.normal() * plane.normal().transpose();
+			const Eigen::VectorXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			for (int i = 0; i < d.size(); i++)
+			{
+				if (d[i] <= 0 || d[i] >= dhat_)
+					continue;
+				// ∇²b(d²) = (b''(d²) 4d² + b'(d²) 2) n nᵀ
+				const double d_sqr = d[i] * d[i];
+				double h = ipc::barrier_second_derivative(d_sqr, dhat_ * dhat_) * 4 * d_sqr
+						   + ipc::barrier_first_derivative(d_sqr, dhat_ * dhat_) * 2;
+				if (project_to_psd_)
+					h = std::max(h, 0.0);
+				h *= plane_weights_[i];
+
+				const int offset = plane_vertex_ids_[i] * dim;
+				for (int r = 0; r < dim; r++)
+					for (int c = 0; c < dim; c++)
+						entries.emplace_back(offset + r, offset + c, h * nnT(r, c));
+			}
+		}
+
+		StiffnessMatrix hessian(V.size(), V.size());
+		hessian.setFromTriplets(entries.begin(), entries.end());
+		return hessian;
+	}
+
+	std::vector<ContactForm::PlaneContact> ContactForm::plane_contacts(const Eigen::MatrixXd &V) const
+	{
+		std::vector<PlaneContact> contacts;
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::VectorXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			for (int i = 0; i < d.size(); i++)
+			{
+				if (d[i] <= 0 || d[i] >= dhat_)
+					continue;
+				// Norm of the barrier gradient, as FrictionCollision::compute_normal_force_magnitude
+				const double db = ipc::barrier_first_derivative(d[i] * d[i], dhat_ * dhat_) * 2 * d[i];
+				contacts.push_back({plane_vertex_ids_[i], plane.normal(), barrier_stiffness_ * plane_weights_[i] * std::abs(db)});
+			}
+		}
+		return contacts;
+	}
+
+	double ContactForm::plane_minimum_distance(const Eigen::MatrixXd &V) const
+	{
+		double min_distance = std::numeric_limits<double>::infinity();
+		if (plane_vertex_ids_.size() == 0)
+			return min_distance;
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::ArrayXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			min_distance = std::min(min_distance, (d > 0 && d < dhat_).select(d.square(), min_distance).minCoeff());
+		}
+		return min_distance;
+	}
+
+	size_t ContactForm::hash_plane_contacts(const Eigen::MatrixXd &V) const
+	{
+		size_t hash = planes_.size();
+		for (int p = 0; p < planes_.size(); p++)
+		{
+			const Eigen::VectorXd d = (V(plane_vertex_ids_, Eigen::all).rowwise() - planes_[p].point().transpose()) * planes_[p].normal();
+			for (int i = 0; i < d.size(); i++)
+			{
+				if (d[i] > 0 && d[i] < dhat_)
+					utils::hash_combine(hash, std::hash<long>()(long(p) * V.rows() + plane_vertex_ids_[i]));
+			}
+		}
+		return hash;
+	}
+
+	double ContactForm::plane_max_step_size(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const
+	{
+		// Same conservative rescaling as the ipc CCD: a vertex never loses more than 80% of its distance to a plane
+		constexpr double conservative_rescaling = 0.8;
+
+		double max_step = 1;
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::ArrayXd d0 = (V0(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			const Eigen::ArrayXd d1 = (V1(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+
+			// Largest t such that d0 + t (d1 - d0) >= (1 - conservative_rescaling) d0
+			const Eigen::ArrayXd t = (conservative_rescaling * d0) / (d0 - d1);
+			max_step = std::min(max_step, (d0 > 0 && d1 < (1 - conservative_rescaling) * d0).select(t, 1.0).minCoeff());
+		}
+		return max_step;
 	}
 
 	Eigen::VectorXd ContactForm::value_per_element_unweighted(const Eigen::VectorXd &x) const
@@ -154,7 +471,7 @@ namespace polyfem::solver
 
 		const size_t num_vertices = collision_mesh_.num_vertices();
 
-		if (collision_set_.empty())
+		if (collision_set_.empty() && planes_.empty())
 		{
 			return Eigen::VectorXd::Zero(collision_mesh_.full_num_vertices());
 		}
@@ -187,6 +504,8 @@ namespace polyfem::solver
 		{
 			out += local_potential;
 		}
+		if (!planes_.empty())
+			out += plane_potentials(V);
 
 		Eigen::VectorXd out_full = Eigen::VectorXd::Zero(collision_mesh_.full_num_vertices());
 		for (int i = 0; i < out.size(); i++)
@@ -199,20 +518,33 @@ namespace polyfem::solver
 
 	void ContactForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
-		gradv = barrier_potential_.gradient(collision_set_, collision_mesh_, compute_displaced_surface(x));
+		const Eigen::MatrixXd V = compute_displaced_surface(x);
+		gradv = barrier_potential_.gradient(collision_set_, collision_mesh_, V);
+		if (!planes_.empty())
+			gradv += plane_gradient(V);
 		gradv = collision_mesh_.to_full_dof(gradv);
 	}
 
 	void ContactForm::second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
 	{
 		POLYFEM_SCOPED_TIMER("barrier hessian");
-		hessian = barrier_potential_.hessian(collision_set_, collision_mesh_, compute_displaced_surface(x), project_to_psd_);
+		if (hessian_pattern_inflation_ >= 0 && hessian_pattern_.size() == 0)
+			build_hessian_pattern(x);
+
+		const Eigen::MatrixXd V = compute_displaced_surface(x);
+		hessian = barrier_potential_.hessian(collision_set_, collision_mesh_, V, project_to_psd_);
+		if (!planes_.empty())
+			hessian += plane_hessian(V);
 		hessian = collision_mesh_.to_full_dof(hessian);
+
+		// The sum keeps the explicit zeros, so the pattern does not change with the collision set
+		if (hessian_pattern_.rows() == hessian.rows() && hessian_pattern_.cols() == hessian.cols())
+			hessian += hessian_pattern_;
 	}
 
 	void ContactForm::solution_changed(const Eigen::VectorXd &new_x)
 	{
-		update_collision_set(compute_displaced_surface(new_x));
+		update_collision_set(new_x);
 	}
 
 	double ContactForm::max_step_size(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
@@ -230,12 +562,25 @@ namespace polyfem::solver
 		}
 
 		double max_step;
-		if (use_cached_candidates_ && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
-			max_step = candidates_.compute_collision_free_stepsize(
+		if ((use_cached_candidates_ || are_candidates_valid(V0, V1)) && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
+			max_step = compute_candidates_toi(V0, V1);
+		else if (use_body_culling())
+		{
+			candidates_toi_.clear();
+			ipc::Candidates candidates;
+			build_body_culled_candidates(V0, V1, /*inflation_radius=*/dmin_ / 2, candidates);
+			max_step = candidates.compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
+		}
 		else
+		{
+			candidates_toi_.clear();
 			max_step = ipc::compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, broad_phase_method_, ccd_tolerance_, ccd_max_iterations_);
+		}
+
+		if (!planes_.empty())
+			max_step = std::min(max_step, plane_max_step_size(V0, V1));
 
 		if (save_ccd_debug_meshes && ipc::has_intersections(collision_mesh_, (V1 - V0) * max_step + V0, broad_phase_method_))
 		{
@@ -244,9 +589,11 @@ namespace polyfem::solver
 
 #ifndef NDEBUG
 		// This will check for static intersections as a failsafe. Not needed if we use our conservative CCD.
+		// The broad phase of the whole motion contains the candidates of every halved step, so it is built only once.
+		const IntersectionCandidates intersection_candidates = build_intersection_candidates(collision_mesh_, V0, V1, broad_phase_method_);
 		Eigen::MatrixXd V_toi = (V1 - V0) * max_step + V0;
 
-		while (ipc::has_intersections(collision_mesh_, V_toi, broad_phase_method_))
+		while (has_intersections(collision_mesh_, intersection_candidates, V_toi))
 		{
 			logger().error("Taking max_step results in intersections (max_step={:g})", max_step);
 			max_step /= 2.0;
@@ -262,21 +609,250 @@ namespace polyfem::solver
 		return max_step;
 	}
 
+	double ContactForm::compute_candidates_toi(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const
+	{
+		POLYFEM_SCOPED_TIMER("narrow phase");
+
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+
+		candidates_toi_.assign(candidates_.size(), 1.0);
+		toi_V0_ = V0;
+		toi_V1_ = V1;
+
+		// Each thread prunes its own candidates with the earliest impact it found so far
+		auto storage = utils::create_thread_storage<double>(1.0);
+		utils::maybe_parallel_for(candidates_.size(), [&](int start, int end, int thread_id) {
+			double &earliest_toi = utils::get_local_thread_storage(storage, thread_id);
+			for (int i = start; i < end; ++i)
+			{
+				const ipc::ContinuousCollisionCandidate &candidate = candidates_[i];
+				double toi;
+				const bool are_colliding = candidate.ccd(
+					candidate.dof(V0, E, F), candidate.dof(V1, E, F), toi, dmin_,
+					/*tmax=*/earliest_toi, ccd_tolerance_, ccd_max_iterations_);
+
+				// Without an impact, the candidate is collision free at least up to the searched interval
+				candidates_toi_[i] = are_colliding ? toi : earliest_toi;
+				if (are_colliding)
+					earliest_toi = std::min(earliest_toi, toi);
+			}
+		});
+
+		double max_step = 1;
+		for (const double earliest_toi : storage)
+			max_step = std::min(max_step, earliest_toi);
+		assert(max_step >= 0 && max_step <= 1);
+		return max_step;
+	}
+
+	bool ContactForm::is_motion_on_candidates_toi(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1, double &alpha) const
+	{
+		if (candidates_toi_.size() != candidates_.size() || toi_V0_.rows() != V0.rows() || toi_V0_.cols() != V0.cols() || toi_V0_ != V0)
+			return false;
+
+		const Eigen::MatrixXd dV = toi_V1_ - toi_V0_;
+		Eigen::Index r, c;
+		const double max_dV = dV.cwiseAbs().maxCoeff(&r, &c);
+		if (max_dV == 0)
+			return false;
+
+		alpha = (V1(r, c) - V0(r, c)) / dV(r, c);
+		if (alpha < 0 || alpha > 1)
+			return false;
+
+		// The line search steps are computed on the full solution, allow for the round-off of the displacement
+		return (V0 + alpha * dV - V1).lpNorm<Eigen::Infinity>() <= 1e-12 * max_dV;
+	}
+
+	void ContactForm::set_broad_phase_margin(const double margin)
+	{
+		assert(margin >= 0);
+		broad_phase_margin_ = margin * dhat_;
+		candidates_.clear();
+		candidates_toi_.clear();
+		candidates_lower_bound_.resize(0, 0);
+		candidates_upper_bound_.resize(0, 0);
+	}
+
+	void ContactForm::set_body_ids(const Eigen::VectorXi &vertex_body_ids)
+	{
+		assert(vertex_body_ids.size() == 0 || vertex_body_ids.size() == collision_mesh_.num_vertices());
+
+		// Number the bodies contiguously
+		std::unordered_map<int, int> body_index;
+		vertex_body_ids_.resize(vertex_body_ids.size());
+		for (int i = 0; i < vertex_body_ids.size(); i++)
+		{
+			const auto it = body_index.emplace(vertex_body_ids[i], body_index.size()).first;
+			vertex_body_ids_[i] = it->second;
+		}
+		n_bodies_ = body_index.size();
+
+		candidates_.clear();
+		candidates_toi_.clear();
+		candidates_lower_bound_.resize(0, 0);
+		candidates_upper_bound_.resize(0, 0);
+	}
+
+	void ContactForm::build_body_culled_candidates(
+		const Eigen::MatrixXd &V0,
+		const Eigen::MatrixXd &V1,
+		const double inflation_radius,
+		ipc::Candidates &candidates) const
+	{
+		assert(vertex_body_ids_.size() == V0.rows());
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+		const int dim = V0.cols();
+
+		// Swept and inflated bounding box of every body
+		Eigen::MatrixXd body_min = Eigen::MatrixXd::Constant(n_bodies_, dim, std::numeric_limits<double>::infinity());
+		Eigen::MatrixXd body_max = Eigen::MatrixXd::Constant(n_bodies_, dim, -std::numeric_limits<double>::infinity());
+		for (int i = 0; i < V0.rows(); i++)
+		{
+			const int b = vertex_body_ids_[i];
+			body_min.row(b) = body_min.row(b).cwiseMin(V0.row(i).cwiseMin(V1.row(i)));
+			body_max.row(b) = body_max.row(b).cwiseMax(V0.row(i).cwiseMax(V1.row(i)));
+		}
+		body_min.array() -= inflation_radius;
+		body_max.array() += inflation_radius;
+
+		// Pairwise body tests, a body without any overlap is skipped entirely
+		std::vector<char> are_bodies_overlapping(n_bodies_ * n_bodies_, false);
+		std::vector<char> is_body_active(n_bodies_, false);
+		for (int a = 0; a < n_bodies_; a++)
+		{
+			for (int b = a + 1; b < n_bodies_; b++)
+			{
+				if ((body_min.row(a).array() <= body_max.row(b).array()).all()
+					&& (body_min.row(b).array() <= body_max.row(a).array()).all())
+				{
+					are_bodies_overlapping[a * n_bodies_ + b] = are_bodies_overlapping[b * n_bodies_ + a] = true;
+					is_body_active[a] = is_body_active[b] = true;
+				}
+			}
+		}
+
+		// Restrict the broad phase to the primitives of the active bodies
+		std::vector<int> local_to_vertex, local_to_edge, local_to_face;
+		Eigen::VectorXi vertex_to_local = Eigen::VectorXi::Constant(V0.rows(), -1);
+		for (int i = 0; i < V0.rows(); i++)
+		{
+			if (is_body_active[vertex_body_ids_[i]])
+			{
+				vertex_to_local[i] = local_to_vertex.size();
+				local_to_vertex.push_back(i);
+			}
+		}
+
+		const auto to_local = [&](const int vi) { return vertex_to_local[vi]; };
+		const auto restrict_elements = [&](const Eigen::MatrixXi &elements, std::vector<int> &local_to_element) {
+			for (int i = 0; i < elements.rows(); i++)
+				if ((elements.row(i).unaryExpr(to_local).array() >= 0).all())
+					local_to_element.push_back(i);
+
+			Eigen::MatrixXi local_elements(local_to_element.size(), elements.cols());
+			for (int i = 0; i < local_to_element.size(); i++)
+				local_elements.row(i) = elements.row(local_to_element[i]).unaryExpr(to_local);
+			return local_elements;
+		};
+		const Eigen::MatrixXi local_E = restrict_elements(E, local_to_edge);
+		const Eigen::MatrixXi local_F = restrict_elements(F, local_to_face);
+
+		candidates.clear();
+		if (local_to_vertex.empty())
+			return;
+
+		std::shared_ptr<ipc::BroadPhase> broad_phase = ipc::BroadPhase::make_broad_phase(broad_phase_method_);
+		broad_phase->can_vertices_collide = [&](size_t vi, size_t vj) {
+			const int i = local_to_vertex[vi], j = local_to_vertex[vj];
+			const int bi = vertex_body_ids_[i], bj = vertex_body_ids_[j];
+			return bi != bj && are_bodies_overlapping[bi * n_bodies_ + bj] && collision_mesh_.can_collide(i, j);
+		};
+		broad_phase->build(
+			V0(local_to_vertex, Eigen::all), V1(local_to_vertex, Eigen::all),
+			local_E, local_F, inflation_radius);
+
+		// Map the candidates back to the primitives of the collision mesh
+		if (dim == 2)
+		{
+			broad_phase->detect_edge_vertex_candidates(candidates.ev_candidates);
+			for (ipc::EdgeVertexCandidate &c : candidates.ev_candidates)
+			{
+				c.edge_id = local_to_edge[c.edge_id];
+				c.vertex_id = local_to_vertex[c.vertex_id];
+			}
+		}
+		else
+		{
+			broad_phase->detect_edge_edge_candidates(candidates.ee_candidates);
+			for (ipc::EdgeEdgeCandidate &c : candidates.ee_candidates)
+			{
+				c.edge0_id = local_to_edge[c.edge0_id];
+				c.edge1_id = local_to_edge[c.edge1_id];
+			}
+
+			broad_phase->detect_face_vertex_candidates(candidates.fv_candidates);
+			for (ipc::FaceVertexCandidate &c : candidates.fv_candidates)
+			{
+				c.face_id = local_to_face[c.face_id];
+				c.vertex_id = local_to_vertex[c.vertex_id];
+			}
+		}
+	}
+
+	bool ContactForm::are_candidates_valid(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const
+	{
+		if (broad_phase_margin_ <= 0 || candidates_lower_bound_.rows() != V0.rows() || candidates_lower_bound_.cols() != V0.cols())
+			return false;
+
+		// If every vertex stays in its inflated box, the swept and inflated bounding box of every primitive
+		// is contained in the one used to build the candidates, so no candidate can be missing.
+		return (V0.array() >= candidates_lower_bound_.array()).all()
+			   && (V0.array() <= candidates_upper_bound_.array()).all()
+			   && (V1.array() >= candidates_lower_bound_.array()).all()
+			   && (V1.array() <= candidates_upper_bound_.array()).all();
+	}
+
+	void ContactForm::build_candidates(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1)
+	{
+		POLYFEM_SCOPED_TIMER("broad phase");
+		candidates_toi_.clear();
+		if (use_body_culling())
+			build_body_culled_candidates(V0, V1, /*inflation_radius=*/dhat_ / 2 + broad_phase_margin_, candidates_);
+		else
+			candidates_.build(
+				collision_mesh_, V0, V1,
+				/*inflation_radius=*/dhat_ / 2 + broad_phase_margin_,
+				broad_phase_method_);
+
+		if (broad_phase_margin_ > 0)
+		{
+			candidates_lower_bound_ = V0.cwiseMin(V1).array() - broad_phase_margin_;
+			candidates_upper_bound_ = V0.cwiseMax(V1).array() + broad_phase_margin_;
+		}
+	}
+
 	void ContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
 	{
-		candidates_.build(
-			collision_mesh_,
-			compute_displaced_surface(x0),
-			compute_displaced_surface(x1),
-			/*inflation_radius=*/dhat_ / 2,
-			broad_phase_method_);
+		const Eigen::MatrixXd V0 = compute_displaced_surface(x0);
+		const Eigen::MatrixXd V1 = compute_displaced_surface(x1);
+
+		if (!are_candidates_valid(V0, V1))
+			build_candidates(V0, V1);
 
 		use_cached_candidates_ = true;
 	}
 
 	void ContactForm::line_search_end()
 	{
-		candidates_.clear();
+		// Keep the candidates if they can be reused in the next line search
+		if (broad_phase_margin_ <= 0)
+		{
+			candidates_.clear();
+			candidates_toi_.clear();
+		}
 		use_cached_candidates_ = false;
 	}
 
@@ -287,7 +863,9 @@ namespace polyfem::solver
 
 		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(data.x);
 
-		const double curr_distance = collision_set_.compute_minimum_distance(collision_mesh_, displaced_surface);
+		double curr_distance = collision_set_.compute_minimum_distance(collision_mesh_, displaced_surface);
+		if (!planes_.empty())
+			curr_distance = std::min(curr_distance, plane_minimum_distance(displaced_surface));
 
 		if (use_adaptive_barrier_stiffness_)
 		{
@@ -316,6 +894,22 @@ namespace polyfem::solver
 		prev_distance_ = curr_distance;
 	}
 
+	void ContactForm::save_snapshot(io::Snapshot &snapshot) const
+	{
+		const std::string prefix = name() + "/";
+		snapshot.set(prefix + "barrier_stiffness", barrier_stiffness_);
+		snapshot.set(prefix + "max_barrier_stiffness", max_barrier_stiffness_);
+		snapshot.set(prefix + "prev_distance", prev_distance_);
+	}
+
+	void ContactForm::load_snapshot(const io::Snapshot &snapshot)
+	{
+		const std::string prefix = name() + "/";
+		barrier_stiffness_ = snapshot.get_scalar(prefix + "barrier_stiffness");
+		max_barrier_stiffness_ = snapshot.get_scalar(prefix + "max_barrier_stiffness");
+		prev_distance_ = snapshot.get_scalar(prefix + "prev_distance");
+	}
+
 	bool ContactForm::is_step_collision_free(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
 	{
 		const auto displaced0 = compute_displaced_surface(x0);
@@ -328,11 +922,57 @@ namespace polyfem::solver
 			return true;
 		}
 
+		// A vertex crossing a plane is the only possible collision with it
+		for (const mesh::Obstacle::Plane &plane : planes_)
+		{
+			const Eigen::ArrayXd d0 = (displaced0(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			const Eigen::ArrayXd d1 = (displaced1(plane_vertex_ids_, Eigen::all).rowwise() - plane.point().transpose()) * plane.normal();
+			if ((d0 > 0 && d1 <= 0).any())
+				return false;
+		}
+
+		double alpha;
+		if (is_motion_on_candidates_toi(displaced0, displaced1, alpha))
+		{
+			// Only the candidates with an impact before alpha in the last max_step_size can collide
+			const Eigen::MatrixXi &E = collision_mesh_.edges();
+			const Eigen::MatrixXi &F = collision_mesh_.faces();
+
+			auto storage = utils::create_thread_storage<int>(0);
+			utils::maybe_parallel_for(candidates_.size(), [&](int start, int end, int thread_id) {
+				int &is_colliding = utils::get_local_thread_storage(storage, thread_id);
+				for (int i = start; i < end && !is_colliding; ++i)
+				{
+					if (candidates_toi_[i] >= alpha)
+						continue;
+
+					const ipc::ContinuousCollisionCandidate &candidate = candidates_[i];
+					double toi;
+					is_colliding = candidate.ccd(
+						candidate.dof(displaced0, E, F), candidate.dof(displaced1, E, F), toi, dmin_,
+						/*tmax=*/1.0, ccd_tolerance_, ccd_max_iterations_);
+				}
+			});
+
+			for (const int is_colliding : storage)
+				if (is_colliding)
+					return false;
+			return true;
+		}
+
 		bool is_valid;
-		if (use_cached_candidates_)
+		if (use_cached_candidates_ || are_candidates_valid(displaced0, displaced1))
 			is_valid = candidates_.is_step_collision_free(
 				collision_mesh_, displaced0, displaced1, dmin_,
 				ccd_tolerance_, ccd_max_iterations_);
+		else if (use_body_culling())
+		{
+			ipc::Candidates candidates;
+			build_body_culled_candidates(displaced0, displaced1, /*inflation_radius=*/dmin_ / 2, candidates);
+			is_valid = candidates.is_step_collision_free(
+				collision_mesh_, displaced0, displaced1, dmin_,
+				ccd_tolerance_, ccd_max_iterations_);
+		}
 		else
 			is_valid = ipc::is_step_collision_free(
 				collision_mesh_, displaced0, displaced1, broad_phase_method_,
@@ -3,6 +3,7 @@
 #include "Form.hpp"
 
 #include <polyfem/Common.hpp>
+#include <polyfem/mesh/Obstacle.hpp>
 #include <polyfem/utils/Types.hpp>
 
 #include <ipc/collisions/collisions.hpp>
@@ -138,9 +139,70 @@ namespace polyfem::solver
 
 		double weight() const override { return weight_ * barrier_stiffness_; }
 
+		/// @brief Store the barrier stiffness and the minimum distance of the last step
+		/// @note The cached candidates are not stored, a restored run rebuilds them from the solution at its first line search
+		/// @param snapshot Snapshot to write into
+		void save_snapshot(io::Snapshot &snapshot) const override;
+
+		/// @brief Restore the barrier stiffness and the minimum distance of the last step
+		/// @param snapshot Snapshot to read from
+		void load_snapshot(const io::Snapshot &snapshot) override;
+
 		/// @brief If true, output debug files
 		bool save_ccd_debug_meshes = false;
 
+		/// @brief Set the extra inflation of the candidate set so it can be reused while the surface moves less than the margin
+		/// @param margin Margin relative to dhat (zero rebuilds the candidates at every line search)
+		void set_broad_phase_margin(const double margin);
+
+		/// @brief Handle the contact with analytic planes in closed form (per surface vertex, no broad phase)
+		/// @param planes Planes of the obstacle
+		/// @param n_obstacle_vertices Number of obstacle vertices at the end of the collision mesh (not in contact with the planes)
+		void set_planes(const std::vector<mesh::Obstacle::Plane> &planes, const int n_obstacle_vertices);
+
+		/// @brief Contact of a collision vertex with an analytic plane
+		struct PlaneContact
+		{
+			int vertex_id;                 ///< Collision vertex in contact
+			VectorNd normal;               ///< Normal of the plane
+			double normal_force_magnitude; ///< Magnitude of the contact force (including the barrier stiffness)
+		};
+
+		/// @brief Contacts of the collision vertices closer than dhat to a plane
+		/// @param V Displaced surface vertices
+		/// @return One contact per vertex and plane
+		std::vector<PlaneContact> plane_contacts(const Eigen::MatrixXd &V) const;
+
+		/// @brief Cull the broad phase with the bounding boxes of the bodies: only primitives of different bodies whose boxes overlap become candidates
+		/// @note Contacts between primitives of the same body are ignored while culling is enabled
+		/// @param vertex_body_ids Body id of each collision vertex (empty to disable the culling)
+		void set_body_ids(const Eigen::VectorXi &vertex_body_ids);
+
+		/// @brief Preallocate the Hessian pattern at the start of each time step from all pairs within an inflated dhat
+		/// @param inflation Inflation of dhat (relative to dhat) used to find the pairs, negative disables the preallocation
+		void set_persistent_hessian_pattern(const double inflation);
+
+		/// @brief Time of impact of each cached candidate computed by the last max_step_size (in the order of the candidates)
+		/// @note Candidates that did not collide store the upper bound of the search, i.e. no impact happens before this value
+		const std::vector<double> &candidates_toi() const { return candidates_toi_; }
+
+		/// @brief Hash of the vertices of the active collisions
+		size_t hessian_state_hash() const override { return collision_set_hash_; }
+
+		/// @brief Check if the cached collision set was built for the solution x
+		/// @param x Solution
+		/// @return True if collision_set() is the collision set of x
+		bool is_collision_set_built_for(const Eigen::VectorXd &x) const;
+
+		/// @brief Preallocated Hessian pattern of explicit zeros (empty if not preallocated yet)
+		const StiffnessMatrix &hessian_pattern() const { return hessian_pattern_; }
+
+		/// @brief Hash of the vertices of every collision in a collision set
+		/// @param collision_set Collision set
+		/// @param collision_mesh Collision mesh of the collision set
+		/// @return Hash, equal for collision sets made of the same pairs in the same order
+		static size_t hash_collision_set(const ipc::Collisions &collision_set, const ipc::CollisionMesh &collision_mesh);
+
 		double dhat() const { return dhat_; }
 		const ipc::Collisions &collision_set() const { return collision_set_; }
 		const ipc::BarrierPotential &barrier_potential() const { return barrier_potential_; }
@@ -150,6 +212,65 @@ namespace polyfem::solver
 		/// @param displaced_surface Vertex positions displaced by the current solution
 		void update_collision_set(const Eigen::MatrixXd &displaced_surface);
 
+		/// @brief Update the cached constraint set for the solution x, unless it was already built for the same solution
+		/// @param x Current solution
+		void update_collision_set(const Eigen::VectorXd &x);
+
+		/// @brief Check if the cached candidates contain all the candidates of the motion from V0 to V1
+		/// @param V0 Surface vertex positions at the start of the motion
+		/// @param V1 Surface vertex positions at the end of the motion
+		/// @return True if the cached candidates can be reused
+		bool are_candidates_valid(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const;
+
+		/// @brief Rebuild the cached candidates for the motion from V0 to V1 (inflated by the broad phase margin)
+		void build_candidates(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1);
+
+		/// @brief Is the broad phase culled with the bounding boxes of the bodies?
+		bool use_body_culling() const { return n_bodies_ > 1 && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE; }
+
+		/// @brief Build the candidates of the motion from V0 to V1 between primitives of overlapping bodies only
+		/// @param[in] V0 Surface vertex positions at the start of the motion
+		/// @param[in] V1 Surface vertex positions at the end of the motion
+		/// @param[in] inflation_radius Inflation of the bounding boxes
+		/// @param[out] candidates Candidates (in the indices of the collision mesh)
+		void build_body_culled_candidates(
+			const Eigen::MatrixXd &V0,
+			const Eigen::MatrixXd &V1,
+			const double inflation_radius,
+			ipc::Candidates &candidates) const;
+
+		/// @brief Barrier potential of each collision vertex with the planes
+		/// @param V Displaced surface vertices
+		/// @param area_weighted If false, skip the weights of the convergent formulation
+		/// @return Potential of each collision vertex (zero for the vertices farther than dhat from every plane)
+		Eigen::VectorXd plane_potentials(const Eigen::MatrixXd &V, const bool area_weighted = true) const;
+		/// @brief Gradient of the barrier potential with the planes wrt the displaced surface vertices (flattened)
+		Eigen::VectorXd plane_gradient(const Eigen::MatrixXd &V, const bool area_weighted = true) const;
+		/// @brief Hessian of the barrier potential with the planes wrt the displaced surface vertices (block diagonal)
+		StiffnessMatrix plane_hessian(const Eigen::MatrixXd &V) const;
+		/// @brief Largest step before a vertex gets closer than a fraction of its distance to a plane
+		double plane_max_step_size(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const;
+		/// @brief Minimum squared distance of the vertices within dhat of a plane (infinity if there is none), as Collisions::compute_minimum_distance
+		double plane_minimum_distance(const Eigen::MatrixXd &V) const;
+		/// @brief Hash of the vertices within dhat of a plane
+		size_t hash_plane_contacts(const Eigen::MatrixXd &V) const;
+
+		/// @brief Rebuild the preallocated Hessian pattern from the pairs of primitives close to the solution x
+		void build_hessian_pattern(const Eigen::VectorXd &x) const;
+
+		/// @brief Compute the time of impact of every cached candidate for the motion from V0 to V1 (in parallel)
+		/// @param V0 Surface vertex positions at the start of the motion
+		/// @param V1 Surface vertex positions at the end of the motion
+		/// @return Earliest time of impact
+		double compute_candidates_toi(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1) const;
+
+		/// @brief Check if the motion from V0 to V1 is a fraction of the motion used to compute candidates_toi_
+		/// @param[in] V0 Surface vertex positions at the start of the motion
+		/// @param[in] V1 Surface vertex positions at the end of the motion
+		/// @param[out] alpha Fraction of the motion used to compute candidates_toi_
+		/// @return True if candidates_toi_ can be used to prune the candidates of the motion
+		bool is_motion_on_candidates_toi(const Eigen::MatrixXd &V0, const Eigen::MatrixXd &V1, double &alpha) const;
+
 		/// @brief Collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -189,9 +310,46 @@ namespace polyfem::solver
 		bool use_cached_candidates_ = false;
 		/// @brief Cached constraint set for the current solution
 		ipc::Collisions collision_set_;
+		/// @brief Hash of the vertices of the cached constraint set
+		size_t collision_set_hash_ = 0;
+		/// @brief Hash of the solution used to build the cached constraint set
+		size_t collision_set_x_hash_ = 0;
+		/// @brief If false, the cached constraint set was not built from a known solution
+		bool is_collision_set_x_hash_valid_ = false;
 		/// @brief Cached candidate set for the current solution
 		ipc::Candidates candidates_;
 
+		/// @brief Extra inflation of the candidates (absolute length), zero disables the reuse of candidates
+		double broad_phase_margin_ = 0;
+		/// @brief Lower corner of the region each surface vertex can move in without invalidating candidates_
+		Eigen::MatrixXd candidates_lower_bound_;
+		/// @brief Upper corner of the region each surface vertex can move in without invalidating candidates_
+		Eigen::MatrixXd candidates_upper_bound_;
+
+		/// @brief Body of each collision vertex (numbered from 0 to n_bodies_ - 1)
+		Eigen::VectorXi vertex_body_ids_;
+		/// @brief Number of bodies, the broad phase is culled only with more than one body
+		int n_bodies_ = 0;
+
+		/// @brief Analytic planes handled in closed form
+		std::vector<mesh::Obstacle::Plane> planes_;
+		/// @brief Collision vertices in contact with the planes (all but the obstacle vertices)
+		Eigen::VectorXi plane_vertex_ids_;
+		/// @brief Weight of the barrier of each vertex of plane_vertex_ids_ (area and dhat scaling of the convergent formulation)
+		Eigen::VectorXd plane_weights_;
+
+		/// @brief Inflation of dhat used to build hessian_pattern_, negative if the pattern is not preallocated
+		double hessian_pattern_inflation_ = -1;
+		/// @brief Explicit zeros in the entries of every pair within the inflated dhat (mutable because it is built lazily in second_derivative_unweighted)
+		mutable StiffnessMatrix hessian_pattern_;
+
+		/// @brief Time of impact of each cached candidate for the motion from toi_V0_ to toi_V1_ (mutable because it is computed in max_step_size)
+		mutable std::vector<double> candidates_toi_;
+		/// @brief Surface vertex positions at the start of the motion used to compute candidates_toi_
+		mutable Eigen::MatrixXd toi_V0_;
+		/// @brief Surface vertex positions at the end of the motion used to compute candidates_toi_
+		mutable Eigen::MatrixXd toi_V1_;
+
 		const ipc::BarrierPotential barrier_potential_;
 	};
 } // namespace polyfem::solver
@@ -360,6 +360,14 @@ namespace polyfem::solver
 			t = Tree();
 	}
 
+	void ElasticForm::set_single_precision_hessian(const bool val)
+	{
+		// Reset the cache: the sparsity pattern is recomputed at the next assembly
+		auto mat_cache = std::make_unique<utils::SparseMatrixCache>();
+		mat_cache->set_single_precision(val);
+		mat_cache_ = std::move(mat_cache);
+	}
+
 	double ElasticForm::max_step_size(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
 	{
 		// TODO: handle polygon and quad
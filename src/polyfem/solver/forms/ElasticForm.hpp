@@ -100,6 +100,10 @@ namespace polyfem::solver
 		/// @brief Reset adaptive quadrature refinement after each complete nonlinear solve.
 		void finish() override;
 
+		/// @brief Accumulate the Hessian values in single precision (energy and gradient stay in double precision)
+		/// @param val True to use single precision
+		void set_single_precision_hessian(const bool val);
+
 	private:
 		const int n_bases_;
 		std::vector<basis::ElementBases> &bases_;
@@ -5,6 +5,11 @@
 
 #include <filesystem>
 
+namespace polyfem::io
+{
+	class Snapshot;
+} // namespace polyfem::io
+
 namespace polyfem::solver
 {
 	class Form
@@ -113,6 +118,19 @@ namespace polyfem::solver
 		/// @brief Get if the form's second derivative is projected to psd
 		bool is_project_to_psd() const { return project_to_psd_; }
 
+		/// @brief Hash of the discrete state the second derivative depends on (e.g., the active contact set)
+		/// @note Used to decide if a previously assembled Hessian can be reused.
+		/// @return Hash value, zero if the second derivative only depends on x
+		virtual size_t hessian_state_hash() const { return 0; }
+
+		/// @brief Store the state carried from one time step to the next that cannot be recomputed from the solution
+		/// @param snapshot Snapshot to write into (entries are prefixed with the form name)
+		virtual void save_snapshot(io::Snapshot &snapshot) const {}
+
+		/// @brief Restore the state stored by save_snapshot
+		/// @param snapshot Snapshot to read from
+		virtual void load_snapshot(const io::Snapshot &snapshot) {}
+
 		/// @brief Enable the form
 		void enable() { enabled_ = true; }
 		/// @brief Disable the form
@@ -1,8 +1,12 @@
 #include "FrictionForm.hpp"
 #include "ContactForm.hpp"
 
+#include <polyfem/utils/HashUtils.hpp>
 #include <polyfem/utils/Timer.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <ipc/friction/smooth_friction_mollifier.hpp>
 
 namespace polyfem::solver
 {
@@ -104,13 +108,20 @@ namespace polyfem::solver
 
 	double FrictionForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
-		return friction_potential_(friction_collision_set_, collision_mesh_, compute_surface_velocities(x)) / dv_dx();
+		const Eigen::MatrixXd velocities = compute_surface_velocities(x);
+		double value = friction_potential_(friction_collision_set_, collision_mesh_, velocities);
+		if (!plane_contacts_.empty())
+			value += plane_potential(velocities);
+		return value / dv_dx();
 	}
 
 	void FrictionForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
-		const Eigen::VectorXd grad_friction = friction_potential_.gradient(
-			friction_collision_set_, collision_mesh_, compute_surface_velocities(x));
+		const Eigen::MatrixXd velocities = compute_surface_velocities(x);
+		Eigen::VectorXd grad_friction = friction_potential_.gradient(
+			friction_collision_set_, collision_mesh_, velocities);
+		if (!plane_contacts_.empty())
+			grad_friction += plane_gradient(velocities);
 		gradv = collision_mesh_.to_full_dof(grad_friction);
 	}
 
@@ -118,24 +129,132 @@ namespace polyfem::solver
 	{
 		POLYFEM_SCOPED_TIMER("friction hessian");
 
-		hessian = dv_dx() * friction_potential_.hessian( //
-					  friction_collision_set_, collision_mesh_, compute_surface_velocities(x), project_to_psd_);
+		const Eigen::MatrixXd velocities = compute_surface_velocities(x);
+		hessian = friction_potential_.hessian(friction_collision_set_, collision_mesh_, velocities, project_to_psd_);
+		if (!plane_contacts_.empty())
+			hessian += plane_hessian(velocities);
+		hessian *= dv_dx();
 
 		hessian = collision_mesh_.to_full_dof(hessian);
+
+		// The friction pairs are a subset of the contact pairs, so the contact pattern keeps this one stable too
+		const StiffnessMatrix &pattern = contact_form_.hessian_pattern();
+		if (pattern.rows() == hessian.rows() && pattern.cols() == hessian.cols())
+			hessian += pattern;
 	}
 
 	void FrictionForm::update_lagging(const Eigen::VectorXd &x, const int iter_num)
 	{
+		POLYFEM_SCOPED_TIMER("friction lagging");
+
 		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(x);
 
+		// The contact form usually holds the collision set of x already, which avoids a broad phase
 		ipc::Collisions collision_set;
-		collision_set.set_use_convergent_formulation(contact_form_.use_convergent_formulation());
-		collision_set.set_are_shape_derivatives_enabled(contact_form_.enable_shape_derivatives());
-		collision_set.build(
-			collision_mesh_, displaced_surface, contact_form_.dhat(), /*dmin=*/0, broad_phase_method_);
+		const bool reuse_contact_collisions = contact_form_.is_collision_set_built_for(x);
+		if (!reuse_contact_collisions)
+		{
+			collision_set.set_use_convergent_formulation(contact_form_.use_convergent_formulation());
+			collision_set.set_are_shape_derivatives_enabled(contact_form_.enable_shape_derivatives());
+			collision_set.build(
+				collision_mesh_, displaced_surface, contact_form_.dhat(), /*dmin=*/0, broad_phase_method_);
+		}
+		const ipc::Collisions &collisions = reuse_contact_collisions ? contact_form_.collision_set() : collision_set;
+
+		// The planes are static, their tangent bases never change
+		plane_contacts_ = contact_form_.plane_contacts(displaced_surface);
+
+		const size_t collisions_hash = ContactForm::hash_collision_set(collisions, collision_mesh_);
+		if (incremental_lagging_ && iter_num > 0 && collisions_hash == friction_collision_set_hash_)
+		{
+			update_normal_forces(displaced_surface);
+			return;
+		}
 
 		friction_collision_set_.build(
-			collision_mesh_, displaced_surface, collision_set,
+			collision_mesh_, displaced_surface, collisions,
 			contact_form_.barrier_potential(), contact_form_.barrier_stiffness(), mu_);
+		friction_collision_set_hash_ = collisions_hash;
+	}
+
+	void FrictionForm::update_normal_forces(const Eigen::MatrixXd &displaced_surface)
+	{
+		const Eigen::MatrixXi &E = collision_mesh_.edges();
+		const Eigen::MatrixXi &F = collision_mesh_.faces();
+
+		utils::maybe_parallel_for(friction_collision_set_.size(), [&](int start, int end, int thread_id) {
+			for (int i = start; i < end; ++i)
+			{
+				ipc::FrictionCollision &collision = friction_collision_set_[i];
+				collision.normal_force_magnitude = collision.compute_normal_force_magnitude(
+					collision.dof(displaced_surface, E, F),
+					contact_form_.barrier_potential(), contact_form_.barrier_stiffness());
+			}
+		});
+	}
+
+	size_t FrictionForm::hessian_state_hash() const
+	{
+		size_t hash = friction_collision_set_hash_;
+		for (const ContactForm::PlaneContact &contact : plane_contacts_)
+			utils::hash_combine(hash, std::hash<int>()(contact.vertex_id));
+		return hash;
+	}
+
+	double FrictionForm::plane_potential(const Eigen::MatrixXd &velocities) const
+	{
+		// Same smoothed Coulomb friction as ipc, with the tangential velocity projected on the plane
+		double value = 0;
+		for (const ContactForm::PlaneContact &contact : plane_contacts_)
+		{
+			const VectorNd v = velocities.row(contact.vertex_id).transpose();
+			const VectorNd u = v - v.dot(contact.normal) * contact.normal;
+			value += mu_ * contact.normal_force_magnitude * ipc::f0_SF(u.norm(), epsv_);
+		}
+		return value;
+	}
+
+	Eigen::VectorXd FrictionForm::plane_gradient(const Eigen::MatrixXd &velocities) const
+	{
+		const int dim = velocities.cols();
+		Eigen::VectorXd grad = Eigen::VectorXd::Zero(velocities.size());
+		for (const ContactForm::PlaneContact &contact : plane_contacts_)
+		{
+			const VectorNd v = velocities.row(contact.vertex_id).transpose();
+			const VectorNd u = v - v.dot(contact.normal) * contact.normal;
+			// ∇f0(‖u‖) = f1(‖u‖)/‖u‖ u, with u already in the tangent plane
+			grad.segment(contact.vertex_id * dim, dim) += mu_ * contact.normal_force_magnitude * ipc::f1_SF_over_x(u.norm(), epsv_) * u;
+		}
+		return grad;
+	}
+
+	StiffnessMatrix FrictionForm::plane_hessian(const Eigen::MatrixXd &velocities) const
+	{
+		const int dim = velocities.cols();
+		std::vector<Eigen::Triplet<double>> entries;
+		for (const ContactForm::PlaneContact &contact : plane_contacts_)
+		{
+			const VectorNd v = velocities.row(contact.vertex_id).transpose();
+			const VectorNd u = v - v.dot(contact.normal) * contact.normal;
+			const double u_norm = u.norm();
+
+			// ∇²f0(‖u‖) = f1/‖u‖ P + (f1'‖u‖ - f1)/‖u‖³ u uᵀ, with P the projection on the plane
+			const MatrixNd P = MatrixNd::Identity(dim, dim) - contact.normal * contact.normal.transpose();
+			MatrixNd local_hessian = ipc::f1_SF_over_x(u_norm, epsv_) * P;
+			if (u_norm > 0)
+				local_hessian += ipc::df1_x_minus_f1_over_x3(u_norm, epsv_) * u * u.transpose();
+			local_hessian *= mu_ * contact.normal_force_magnitude;
+			if (project_to_psd_)
+				local_hessian = ipc::project_to_psd(local_hessian);
+
+			const int offset = contact.vertex_id * dim;
+			for (int r = 0; r < dim; r++)
+				for (int c = 0; c < dim; c++)
+					entries.emplace_back(offset + r, offset + c, local_hessian(r, c));
+		}
+
+		StiffnessMatrix hessian(velocities.size(), velocities.size());
+		hessian.setFromTriplets(entries.begin(), entries.end());
+		return hessian;
 	}
 } // namespace polyfem::solver
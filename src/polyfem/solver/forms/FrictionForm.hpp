@@ -10,9 +10,10 @@
 #include <ipc/friction/friction_collisions.hpp>
 #include <ipc/potentials/friction_potential.hpp>
 
+#include <polyfem/solver/forms/ContactForm.hpp>
+
 namespace polyfem::solver
 {
-	class ContactForm;
 
 	/// @brief Form of the lagged friction disapative potential and forces
 	class FrictionForm : public Form
@@ -58,6 +59,7 @@ namespace polyfem::solver
 
 	public:
 		/// @brief Initialize lagged fields
+		/// @note Called at the start of every time step, so the lagged fields are rebuilt from the solution and not stored in restart snapshots
 		/// @param x Current solution
 		void init_lagging(const Eigen::VectorXd &x) override { update_lagging(x, 0); }
 
@@ -83,12 +85,47 @@ namespace polyfem::solver
 		/// @brief Compute the derivative of the velocities wrt x
 		double dv_dx() const;
 
+		/// @brief Only update the normal forces in the lagging iterations of a time step whose contact pairs did not change
+		/// @note The tangent bases and closest points stay lagged from the start of the time step (or the last change of the pairs)
+		/// @param val True to update the lagged fields incrementally
+		void set_incremental_lagging(const bool val) { incremental_lagging_ = val; }
+
 		double mu() const { return mu_; }
 		double epsv() const { return epsv_; }
 		const ipc::FrictionCollisions &friction_collision_set() const { return friction_collision_set_; }
+
+		/// @brief Lagged contacts with the analytic planes of the contact form
+		const std::vector<ContactForm::PlaneContact> &plane_contacts() const { return plane_contacts_; }
+
+		/// @brief Replace the lagged friction collisions (e.g., to restore a previous time step)
+		/// @param friction_collision_set Lagged friction collisions
+		/// @param plane_contacts Lagged contacts with the analytic planes
+		void set_friction_collision_set(
+			const ipc::FrictionCollisions &friction_collision_set,
+			const std::vector<ContactForm::PlaneContact> &plane_contacts)
+		{
+			friction_collision_set_ = friction_collision_set;
+			plane_contacts_ = plane_contacts;
+			friction_collision_set_hash_ = 0; // unknown pairs, the next lagging update rebuilds the set
+		}
 		const ipc::FrictionPotential &friction_potential() const { return friction_potential_; }
 
+		/// @brief Hash of the lagged contact pairs (including the contacts with the analytic planes)
+		size_t hessian_state_hash() const override;
+
 	private:
+		/// @brief Recompute the normal force magnitudes of the lagged friction collisions (in parallel)
+		/// @param displaced_surface Vertex positions displaced by the current solution
+		void update_normal_forces(const Eigen::MatrixXd &displaced_surface);
+
+		/// @brief Friction potential of the lagged contacts with the planes (the planes are static)
+		/// @param velocities Surface velocities
+		double plane_potential(const Eigen::MatrixXd &velocities) const;
+		/// @brief Gradient of the plane friction potential wrt the surface velocities (flattened)
+		Eigen::VectorXd plane_gradient(const Eigen::MatrixXd &velocities) const;
+		/// @brief Hessian of the plane friction potential wrt the surface velocities (block diagonal)
+		StiffnessMatrix plane_hessian(const Eigen::MatrixXd &velocities) const;
+
 		/// Reference to the collision mesh
 		const ipc::CollisionMesh &collision_mesh_;
 
@@ -101,6 +138,9 @@ namespace polyfem::solver
 		const int n_lagging_iters_;                      ///< Number of lagging iterations
 
 		ipc::FrictionCollisions friction_collision_set_; ///< Lagged friction constraint set
+		std::vector<ContactForm::PlaneContact> plane_contacts_; ///< Lagged contacts with the analytic planes of the contact form
+		size_t friction_collision_set_hash_ = 0;         ///< Hash of the contact pairs of friction_collision_set_
+		bool incremental_lagging_ = false;               ///< Only update the normal forces while the contact pairs do not change
 
 		const ContactForm &contact_form_; ///< necessary to have the barrier stiffnes, maybe clean me
 
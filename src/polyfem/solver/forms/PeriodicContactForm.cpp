@@ -25,6 +25,8 @@ namespace polyfem::solver
 
         update_projection();
 
+        rest_extent_ = collision_mesh_.rest_positions().size() > 0 ? collision_mesh_.rest_positions().lpNorm<Eigen::Infinity>() : 0;
+
         // const Eigen::MatrixXd displaced = collision_mesh_.displace_vertices(
         //     Eigen::MatrixXd::Zero(collision_mesh_.full_num_vertices(), collision_mesh_.dim()));
 
@@ -139,9 +141,43 @@ namespace polyfem::solver
         return ContactForm::max_step_size(single_to_tiled(x0), single_to_tiled(x1));
     }
 
+    double PeriodicContactForm::tiled_motion_bound(const Eigen::VectorXd &x) const
+    {
+        const int dim = collision_mesh_.dim();
+        assert(x.size() == candidates_x_.size());
+
+        const Eigen::VectorXd delta = x - candidates_x_;
+        const double fluctuation_motion = delta.head(n_single_dof_ * dim).lpNorm<Eigen::Infinity>();
+        // Row-sum norm of the change of macro strain, i.e. the largest motion of a unit rest position
+        const Eigen::MatrixXd strain_delta = utils::unflatten(delta.tail(dim * dim), dim);
+        const double strain_motion = strain_delta.cwiseAbs().rowwise().sum().maxCoeff() * rest_extent_;
+
+        return fluctuation_motion + strain_motion;
+    }
+
     void PeriodicContactForm::line_search_begin(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) 
     {
-        ContactForm::line_search_begin(single_to_tiled(x0), single_to_tiled(x1));
+        // The tiled vertices move with the fluctuation and the macro strain: bound their motion from
+        // these deltas to reuse the candidates without tiling the solutions.
+        if (broad_phase_margin_ > 0 && candidates_lower_bound_.size() > 0 && candidates_x_.size() == x0.size()
+            && tiled_motion_bound(x0) <= broad_phase_margin_ && tiled_motion_bound(x1) <= broad_phase_margin_)
+        {
+            use_cached_candidates_ = true;
+            return;
+        }
+
+        const Eigen::MatrixXd V0 = compute_displaced_surface(single_to_tiled(x0));
+        const Eigen::MatrixXd V1 = compute_displaced_surface(single_to_tiled(x1));
+
+        if (!are_candidates_valid(V0, V1))
+        {
+            build_candidates(V0, V1);
+            // The candidates cover the motion of every vertex up to the margin from V0
+            if (broad_phase_margin_ > 0)
+                candidates_x_ = x0;
+        }
+
+        use_cached_candidates_ = true;
     }
 
     void PeriodicContactForm::solution_changed(const Eigen::VectorXd &new_x) 
@@ -93,8 +93,18 @@ namespace polyfem::solver
     private:
 		void update_projection() const;
 
+		/// @brief Bound on the motion of every tiled vertex between the solution used to build the candidates and x
+		/// @param x Solution in the [fluctuation, affine] format
+		/// @return Upper bound of the infinity norm of the displacement change of the tiled vertices
+		double tiled_motion_bound(const Eigen::VectorXd &x) const;
+
         const Eigen::VectorXi tiled_to_single_;
 		const int n_single_dof_;
 		mutable StiffnessMatrix proj;
+
+		/// @brief Largest coordinate (in absolute value) of the rest positions of the tiled mesh
+		double rest_extent_;
+		/// @brief Solution used to build the cached candidates (empty if the candidates are not keyed)
+		Eigen::VectorXd candidates_x_;
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "VariableToSimulation.hpp"
 #include <polyfem/State.hpp>
 #include <polyfem/io/MatrixIO.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/assembler/ViscousDamping.hpp>
 #include <polyfem/solver/Optimizations.hpp>
 
@@ -75,6 +76,35 @@ namespace polyfem::solver
 		return Eigen::VectorXi();
 	}
 
+	Eigen::VectorXd VariableToSimulation::sum_state_adjoint_terms(const std::function<void(const std::shared_ptr<State> &, Eigen::VectorXd &)> &state_term) const
+	{
+		// one slot per state keeps the sum order deterministic
+		std::vector<Eigen::VectorXd> terms(states_.size());
+		if (solve_in_parallel_)
+		{
+			// states are independent after their adjoint solves
+			utils::maybe_parallel_for(states_.size(), [&](int start, int end, int thread_id) {
+				for (int i = start; i < end; i++)
+					state_term(states_[i], terms[i]);
+			});
+		}
+		else
+		{
+			for (int i = 0; i < states_.size(); i++)
+				state_term(states_[i], terms[i]);
+		}
+
+		Eigen::VectorXd term;
+		for (const Eigen::VectorXd &cur_term : terms)
+		{
+			if (term.size() != cur_term.size())
+				term = cur_term;
+			else
+				term += cur_term;
+		}
+		return term;
+	}
+
 	Eigen::VectorXd VariableToSimulation::apply_parametrization_jacobian(const Eigen::VectorXd &term, const Eigen::VectorXd &x) const
 	{
 		return parametrization_.apply_jacobian(term(get_output_indexing(x)), x);
@@ -160,9 +190,7 @@ namespace polyfem::solver
 	}
 	Eigen::VectorXd ShapeVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_shape_transient_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
@@ -172,12 +200,7 @@ namespace polyfem::solver
 				else
 					AdjointTools::dJ_shape_homogenization_adjoint_term(*state, state->diff_cached.u(0), state->get_adjoint_mat(0), cur_term);
 			}
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	Eigen::VectorXd ShapeVariableToSimulation::inverse_eval()
@@ -234,19 +257,12 @@ namespace polyfem::solver
 	}
 	Eigen::VectorXd ElasticVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_material_transient_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
 				AdjointTools::dJ_material_static_adjoint_term(*state, state->diff_cached.u(0), state->get_adjoint_mat(0), cur_term);
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	Eigen::VectorXd ElasticVariableToSimulation::inverse_eval()
@@ -297,19 +313,12 @@ namespace polyfem::solver
 	}
 	Eigen::VectorXd FrictionCoeffientVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_friction_transient_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
 				log_and_throw_adjoint_error("[{}] Gradient in static simulations not implemented!", name());
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	Eigen::VectorXd FrictionCoeffientVariableToSimulation::inverse_eval()
@@ -348,19 +357,12 @@ namespace polyfem::solver
 	}
 	Eigen::VectorXd DampingCoeffientVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_damping_transient_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
 				log_and_throw_adjoint_error("[{}] Static simulation not supported!", name());
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	Eigen::VectorXd DampingCoeffientVariableToSimulation::inverse_eval()
@@ -383,19 +385,12 @@ namespace polyfem::solver
 	}
 	Eigen::VectorXd InitialConditionVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_initial_condition_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
 				log_and_throw_adjoint_error("[{}] Static simulation not supported!", name());
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	Eigen::VectorXd InitialConditionVariableToSimulation::inverse_eval()
@@ -425,19 +420,12 @@ namespace polyfem::solver
 
 	Eigen::VectorXd DirichletVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 				AdjointTools::dJ_dirichlet_transient_adjoint_term(*state, state->get_adjoint_mat(1), state->get_adjoint_mat(0), cur_term);
 			else
 				log_and_throw_adjoint_error("[{}] Static dirichlet boundary optimization not supported!", name());
-
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 	std::string DirichletVariableToSimulation::variable_to_string(const Eigen::VectorXd &variable)
@@ -511,9 +499,7 @@ namespace polyfem::solver
 
 	Eigen::VectorXd PressureVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 			{
 				Eigen::MatrixXd adjoint_nu, adjoint_p;
@@ -525,11 +511,7 @@ namespace polyfem::solver
 			{
 				AdjointTools::dJ_pressure_static_adjoint_term(*state, pressure_boundaries_, state->diff_cached.u(0), state->get_adjoint_mat(0), cur_term);
 			}
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return apply_parametrization_jacobian(term, x);
 	}
 
@@ -589,9 +571,7 @@ namespace polyfem::solver
 
 	Eigen::VectorXd PeriodicShapeVariableToSimulation::compute_adjoint_term(const Eigen::VectorXd &x) const
 	{
-		Eigen::VectorXd term, cur_term;
-		for (auto state : states_)
-		{
+		const Eigen::VectorXd term = sum_state_adjoint_terms([&](const std::shared_ptr<State> &state, Eigen::VectorXd &cur_term) {
 			if (state->problem->is_time_dependent())
 			{
 				log_and_throw_error("Not implemented!");
@@ -600,11 +580,7 @@ namespace polyfem::solver
 			{
 				AdjointTools::dJ_periodic_shape_adjoint_term(*state, *periodic_mesh_map, periodic_mesh_representation, state->diff_cached.u(0), state->get_adjoint_mat(0), cur_term);
 			}
-			if (term.size() != cur_term.size())
-				term = cur_term;
-			else
-				term += cur_term;
-		}
+		});
 		return VariableToSimulation::apply_parametrization_jacobian(term, x);
 	}
 	void PeriodicShapeVariableToSimulation::update(const Eigen::VectorXd &x)
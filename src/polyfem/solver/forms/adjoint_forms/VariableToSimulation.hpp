@@ -38,10 +38,20 @@ namespace polyfem::solver
 
 		virtual Eigen::VectorXd apply_parametrization_jacobian(const Eigen::VectorXd &term, const Eigen::VectorXd &x) const;
 
+		/// @brief Evaluate the adjoint terms of the states in parallel (only if the states are solved in parallel)
+		inline void set_solve_in_parallel(const bool solve_in_parallel) { solve_in_parallel_ = solve_in_parallel; }
+
 	protected:
 		virtual void update_state(const Eigen::VectorXd &state_variable, const Eigen::VectorXi &indices);
+
+		/// @brief Sum the adjoint terms of all states, evaluating the states in parallel if enabled
+		/// @param state_term Computes the adjoint term of one state
+		/// @return Sum of the adjoint terms (empty if there is no state)
+		Eigen::VectorXd sum_state_adjoint_terms(const std::function<void(const std::shared_ptr<State> &, Eigen::VectorXd &)> &state_term) const;
+
 		const std::vector<std::shared_ptr<State>> states_;
 		CompositeParametrization parametrization_;
+		bool solve_in_parallel_ = false;
 
 		Eigen::VectorXi output_indexing_; // if a derived class overrides apply_parametrization_jacobian(term, x), this is not necessarily used.
 	};
@@ -57,6 +67,13 @@ namespace polyfem::solver
 
 		void init(const json &args, const std::vector<std::shared_ptr<State>> &states, const std::vector<int> &variable_sizes);
 
+		/// @brief Evaluate the adjoint terms of the states in parallel (only if the states are solved in parallel)
+		inline void set_solve_in_parallel(const bool solve_in_parallel)
+		{
+			for (auto &v2s : L)
+				v2s->set_solve_in_parallel(solve_in_parallel);
+		}
+
 		/// @brief Update parameters in simulators
 		/// @param x Optimization variable
 		inline void update(const Eigen::VectorXd &x)
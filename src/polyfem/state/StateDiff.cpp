@@ -6,13 +6,17 @@
 
 #include <polyfem/utils/BoundarySampler.hpp>
 #include <polysolve/linear/FEMSolver.hpp>
+#include <polyfem/utils/HashUtils.hpp>
 #include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/utils/StringUtils.hpp>
+#include <polyfem/utils/Timer.hpp>
 #include <polyfem/io/Evaluator.hpp>
 
 #include <polyfem/solver/NLProblem.hpp>
 #include <polyfem/solver/NLHomoProblem.hpp>
 
+#include <polyfem/solver/forms/BCLagrangianForm.hpp>
+#include <polyfem/solver/forms/BCPenaltyForm.hpp>
 #include <polyfem/solver/forms/BodyForm.hpp>
 #include <polyfem/solver/forms/ContactForm.hpp>
 #include <polyfem/solver/forms/ElasticForm.hpp>
@@ -33,6 +37,7 @@
 #include <algorithm>
 
 #include <fstream>
+#include <future>
 
 using namespace polyfem::basis;
 
@@ -64,6 +69,31 @@ namespace polyfem
 			}
 			reduced_mat.setFromTriplets(coeffs.begin(), coeffs.end());
 		}
+
+		/// @brief Fingerprint of the sparsity pattern of a compressed matrix
+		size_t sparsity_pattern_hash(const StiffnessMatrix &mat)
+		{
+			assert(mat.isCompressed());
+			size_t seed = 0;
+			utils::hash_combine(seed, std::hash<int>()(mat.rows()));
+			utils::hash_combine(seed, std::hash<int>()(mat.cols()));
+			utils::hash_combine(seed, std::hash<int>()(mat.nonZeros()));
+			for (int k = 0; k <= mat.outerSize(); ++k)
+				utils::hash_combine(seed, std::hash<int>()(mat.outerIndexPtr()[k]));
+			for (int k = 0; k < mat.nonZeros(); ++k)
+				utils::hash_combine(seed, std::hash<int>()(mat.innerIndexPtr()[k]));
+			return seed;
+		}
+
+		/// @brief Fingerprint of the nonzero values of a compressed matrix
+		size_t sparsity_values_hash(const StiffnessMatrix &mat)
+		{
+			assert(mat.isCompressed());
+			size_t seed = 0;
+			for (int k = 0; k < mat.nonZeros(); ++k)
+				utils::hash_combine(seed, std::hash<double>()(mat.valuePtr()[k]));
+			return seed;
+		}
 	} // namespace
 
 	void State::get_vertices(Eigen::MatrixXd &vertices) const
@@ -101,14 +131,27 @@ namespace polyfem
 	{
 		StiffnessMatrix gradu_h(sol.size(), sol.size());
 		if (current_step == 0)
+		{
+			const json &checkpointing = args["solver"]["advanced"]["adjoint_checkpointing"];
+			const bool is_transient = problem->is_time_dependent() && !args["time"]["quasistatic"].get<bool>();
+			const bool spill = is_transient && checkpointing["spill_to_disk"].get<bool>();
+			// One file per state, several states of an optimization share the output directory
+			diff_cached.set_spill_file(spill ? resolve_output_path(fmt::format("adjoint_jacobians_{}.bin", diff_cached.id())) : "");
+			if (is_transient && !spill && checkpointing["enabled"].get<bool>())
+				diff_cached.set_jacobian_memory_budget(checkpointing["memory_budget"].get<double>() * 1024 * 1024);
+			else
+				diff_cached.set_jacobian_memory_budget(-1);
+
 			diff_cached.init(mesh->dimension(), ndof(), problem->is_time_dependent() ? args["time"]["time_steps"].get<int>() : 0);
+		}
 
 		ipc::Collisions cur_collision_set;
 		ipc::FrictionCollisions cur_friction_set;
 
 		if (optimization_enabled == solver::CacheLevel::Derivatives)
 		{
-			if (!problem->is_time_dependent() || current_step > 0)
+			// Jacobians over the memory budget are recomputed in the adjoint solve
+			if (!problem->is_time_dependent() || (current_step > 0 && diff_cached.has_jacobian_budget()))
 				compute_force_jacobian(sol, disp_grad, gradu_h);
 
 			cur_collision_set = solve_data.contact_form ? solve_data.contact_form->collision_set() : ipc::Collisions();
@@ -152,7 +195,11 @@ namespace polyfem
 					acc = solve_data.time_integrator->compute_acceleration(vel);
 				}
 
-				diff_cached.cache_quantities_transient(current_step, solve_data.time_integrator->steps(), sol, vel, acc, gradu_h, cur_collision_set, cur_friction_set);
+				const double dt = solve_data.time_integrator->dt();
+				const double time = current_step == 0 ? args["time"]["t0"].get<double>() : (diff_cached.time(current_step - 1) + dt);
+				diff_cached.cache_quantities_transient(
+					current_step, solve_data.time_integrator->steps(), time, dt, sol, vel, acc, gradu_h, cur_collision_set, cur_friction_set,
+					solve_data.contact_form ? solve_data.contact_form->barrier_stiffness() : 0);
 			}
 		}
 		else
@@ -171,7 +218,11 @@ namespace polyfem
 			StiffnessMatrix tmp_hess;
 			solve_data.nl_problem->set_project_to_psd(false);
 			solve_data.nl_problem->FullNLProblem::solution_changed(sol);
-			solve_data.nl_problem->FullNLProblem::hessian(sol, tmp_hess);
+			// Reuse the Hessian of the nonlinear solve if it was assembled at (or close enough to) sol
+			if (solve_data.nl_problem->last_hessian(sol, args["solver"]["advanced"]["adjoint_hessian_reuse_tolerance"], tmp_hess))
+				adjoint_logger().trace("Reusing the Hessian of the nonlinear solve as the force Jacobian");
+			else
+				solve_data.nl_problem->FullNLProblem::hessian(sol, tmp_hess);
 			hessian.setZero();
 			replace_rows_by_identity(hessian, tmp_hess, boundary_nodes);
 		}
@@ -202,6 +253,60 @@ namespace polyfem
 		}
 	}
 
+	void State::restore_transient_solve_state(
+		const Eigen::MatrixXd &x_prevs,
+		const Eigen::MatrixXd &v_prevs,
+		const Eigen::MatrixXd &a_prevs,
+		const double t,
+		const double dt,
+		const double barrier_stiffness,
+		const ipc::FrictionCollisions &friction_collision_set,
+		const std::vector<solver::ContactForm::PlaneContact> &friction_plane_contacts)
+	{
+		// Keeps the predictor subspace of the forward simulation
+		solve_data.time_integrator->set_history(x_prevs, v_prevs, a_prevs, dt);
+		solve_data.update_dt();
+		solve_data.nl_problem->update_quantities(t, x_prevs.col(0));
+
+		// The force Jacobians are the Hessians of the final solve of each step, which has the DBC projected out
+		if (solve_data.al_pen_form)
+			solve_data.al_pen_form->disable();
+		if (solve_data.al_lagr_form)
+			solve_data.al_lagr_form->disable();
+
+		if (solve_data.contact_form)
+			solve_data.contact_form->set_barrier_stiffness(barrier_stiffness);
+		if (solve_data.friction_form)
+			solve_data.friction_form->set_friction_collision_set(friction_collision_set, friction_plane_contacts);
+	}
+
+	void State::recompute_transient_force_jacobian(const int step, StiffnessMatrix &hessian)
+	{
+		assert(step > 0);
+
+		// History of the time integrator when the step was solved (the most recent solution first)
+		const int n_prevs = diff_cached.bdf_order(step);
+		Eigen::MatrixXd x_prevs(ndof(), n_prevs), v_prevs(ndof(), n_prevs), a_prevs(ndof(), n_prevs);
+		for (int j = 0; j < n_prevs; ++j)
+		{
+			x_prevs.col(j) = diff_cached.u(step - 1 - j);
+			v_prevs.col(j) = diff_cached.v(step - 1 - j);
+			a_prevs.col(j) = diff_cached.acc(step - 1 - j);
+		}
+		// Analytic planes are rejected in differentiable simulations, there are no lagged plane contacts
+		restore_transient_solve_state(
+			x_prevs, v_prevs, a_prevs,
+			diff_cached.time(step), diff_cached.dt(step),
+			diff_cached.barrier_stiffness(step), diff_cached.friction_collision_set(step), {});
+
+		const Eigen::VectorXd u = diff_cached.u(step);
+		StiffnessMatrix tmp_hess;
+		solve_data.nl_problem->set_project_to_psd(false);
+		solve_data.nl_problem->FullNLProblem::solution_changed(u);
+		solve_data.nl_problem->FullNLProblem::hessian(u, tmp_hess);
+		replace_rows_by_identity(hessian, tmp_hess, boundary_nodes);
+	}
+
 	void State::compute_force_jacobian_prev(const int force_step, const int sol_step, StiffnessMatrix &hessian_prev) const
 	{
 		assert(force_step > 0);
@@ -322,7 +427,7 @@ namespace polyfem
 		diff_cached.cache_adjoints(solve_adjoint(rhs));
 	}
 
-	Eigen::MatrixXd State::solve_adjoint(const Eigen::MatrixXd &rhs) const
+	Eigen::MatrixXd State::solve_adjoint(const Eigen::MatrixXd &rhs)
 	{
 		if (problem->is_time_dependent())
 			return solve_transient_adjoint(rhs);
@@ -371,11 +476,34 @@ namespace polyfem
 		}
 		else
 		{
-			auto solver = polysolve::linear::Solver::create(args["solver"]["adjoint_linear"], adjoint_logger());
-
 			StiffnessMatrix A = diff_cached.gradu_h(0); // This should be transposed, but A is symmetric in hyper-elastic and diffusion problems
-			solver->analyze_pattern(A, A.rows());
-			solver->factorize(A);
+			A.makeCompressed();
+
+			// Reuse the symbolic analysis and the factorization of the previous call when the matrix did not change
+			const size_t pattern_hash = sparsity_pattern_hash(A);
+			const size_t values_hash = sparsity_values_hash(A);
+			if (!adjoint_solver_cached || adjoint_solver_pattern_hash != pattern_hash)
+			{
+				if (!adjoint_solver_cached)
+					adjoint_solver_cached = polysolve::linear::Solver::create(args["solver"]["adjoint_linear"], adjoint_logger());
+				adjoint_solver_cached->analyze_pattern(A, A.rows());
+				adjoint_solver_pattern_hash = pattern_hash;
+				adjoint_solver_factorized = false;
+			}
+			else
+				adjoint_logger().trace("Reusing the symbolic analysis of the adjoint matrix");
+
+			if (!adjoint_solver_factorized || adjoint_solver_values_hash != values_hash)
+			{
+				adjoint_solver_factorized = false;
+				adjoint_solver_cached->factorize(A);
+				adjoint_solver_values_hash = values_hash;
+				adjoint_solver_factorized = true;
+			}
+			else
+				adjoint_logger().trace("Reusing the factorization of the adjoint matrix");
+
+			polysolve::linear::Solver &solver = *adjoint_solver_cached;
 
 			/*
 			For non-periodic problems, the adjoint solution p's size is the full size in NLProblem
@@ -390,7 +518,7 @@ namespace polyfem
 
 					Eigen::VectorXd x;
 					x.setZero(tmp.size());
-					solver->solve(tmp, x);
+					solver.solve(tmp, x);
 
 					adjoint.col(i) = solve_data.nl_problem->reduced_to_full(x);
 				}
@@ -406,7 +534,7 @@ namespace polyfem
 
 					Eigen::VectorXd x;
 					x.setZero(tmp.size());
-					solver->solve(tmp, x);
+					solver.solve(tmp, x);
 					x.conservativeResize(adjoint.rows());
 
 					adjoint.col(i) = x;
@@ -417,7 +545,7 @@ namespace polyfem
 		return adjoint;
 	}
 
-	Eigen::MatrixXd State::solve_transient_adjoint(const Eigen::MatrixXd &adjoint_rhs) const
+	Eigen::MatrixXd State::solve_transient_adjoint(const Eigen::MatrixXd &adjoint_rhs)
 	{
 		const double dt = args["time"]["dt"];
 		const int time_steps = args["time"]["time_steps"];
@@ -442,6 +570,50 @@ namespace polyfem
 		StiffnessMatrix reduced_mass;
 		replace_rows_by_identity(reduced_mass, mass, boundary_nodes);
 
+		// Snapshot of the end of the forward solve, restored after recomputing force Jacobians
+		bool recompute_jacobians = false;
+		for (int i = 1; i <= time_steps; ++i)
+			recompute_jacobians |= !diff_cached.has_gradu_h(i) && !diff_cached.is_gradu_h_spilled(i);
+		Eigen::MatrixXd final_x_prevs, final_v_prevs, final_a_prevs;
+		double final_dt = 0;
+		double final_barrier_stiffness = 0;
+		ipc::FrictionCollisions final_friction_set;
+		std::vector<solver::ContactForm::PlaneContact> final_friction_plane_contacts;
+		if (recompute_jacobians)
+		{
+			const int n_prevs = solve_data.time_integrator->steps();
+			final_dt = solve_data.time_integrator->dt();
+			final_x_prevs.resize(ndof(), n_prevs);
+			final_v_prevs.resize(ndof(), n_prevs);
+			final_a_prevs.resize(ndof(), n_prevs);
+			for (int j = 0; j < n_prevs; ++j)
+			{
+				final_x_prevs.col(j) = solve_data.time_integrator->x_prevs()[j];
+				final_v_prevs.col(j) = solve_data.time_integrator->v_prevs()[j];
+				final_a_prevs.col(j) = solve_data.time_integrator->a_prevs()[j];
+			}
+			if (solve_data.contact_form)
+				final_barrier_stiffness = solve_data.contact_form->barrier_stiffness();
+			if (solve_data.friction_form)
+			{
+				final_friction_set = solve_data.friction_form->friction_collision_set();
+				final_friction_plane_contacts = solve_data.friction_form->plane_contacts();
+			}
+		}
+		int n_recomputed = 0;
+		double recompute_time = 0;
+		utils::Timer backward_timer;
+
+		// Spilled Jacobians are streamed back in reverse order, reading step i - 1 while step i is processed
+		std::future<StiffnessMatrix> prefetched_gradu_h;
+		const auto prefetch_gradu_h = [&](const int step) {
+			if (step > 0 && diff_cached.is_gradu_h_spilled(step))
+				prefetched_gradu_h = std::async(std::launch::async, [this, step]() { return diff_cached.load_gradu_h(step); });
+		};
+		int n_loaded = 0;
+		double load_wait_time = 0;
+		prefetch_gradu_h(time_steps);
+
 		Eigen::MatrixXd sum_alpha_p, sum_alpha_nu;
 		for (int i = time_steps; i >= 0; --i)
 		{
@@ -476,10 +648,28 @@ namespace polyfem
 			{
 				double beta_dt = time_integrator::BDF::betas(diff_cached.bdf_order(i) - 1) * dt;
 
-				rhs_ += (1. / beta_dt) * (diff_cached.gradu_h(i) - reduced_mass).transpose() * sum_alpha_p;
+				StiffnessMatrix uncached_gradu_h;
+				if (diff_cached.is_gradu_h_spilled(i))
+				{
+					{
+						POLYFEM_SCOPED_TIMER(load_wait_time);
+						uncached_gradu_h = prefetched_gradu_h.get();
+					}
+					n_loaded++;
+					prefetch_gradu_h(i - 1);
+				}
+				else if (!diff_cached.has_gradu_h(i))
+				{
+					POLYFEM_SCOPED_TIMER(recompute_time);
+					recompute_transient_force_jacobian(i, uncached_gradu_h);
+					n_recomputed++;
+				}
+				const StiffnessMatrix &gradu_h = diff_cached.has_gradu_h(i) ? diff_cached.gradu_h(i) : uncached_gradu_h;
+
+				rhs_ += (1. / beta_dt) * (gradu_h - reduced_mass).transpose() * sum_alpha_p;
 
 				{
-					StiffnessMatrix A = diff_cached.gradu_h(i).transpose();
+					StiffnessMatrix A = gradu_h.transpose();
 					Eigen::VectorXd b_ = rhs_;
 					b_(boundary_nodes).setZero();
 
@@ -497,7 +687,7 @@ namespace polyfem
 				if (i + 2 < cols_per_adjoint)
 					tmp += (1. / beta_dt) * adjoints(boundary_nodes, i + 2);
 
-				tmp -= (diff_cached.gradu_h(i).transpose() * adjoints.col(i + cols_per_adjoint))(boundary_nodes);
+				tmp -= (gradu_h.transpose() * adjoints.col(i + cols_per_adjoint))(boundary_nodes);
 				adjoints(boundary_nodes, i + cols_per_adjoint) = tmp;
 				adjoints.col(i) = beta_dt * adjoints.col(i + cols_per_adjoint) - sum_alpha_p;
 			}
@@ -507,6 +697,27 @@ namespace polyfem
 				adjoints.col(i + cols_per_adjoint) = rhs_; // adjoint_nu[0] actually stores adjoint_mu[0]
 			}
 		}
+
+		backward_timer.stop();
+
+		if (n_loaded > 0)
+			adjoint_logger().info(
+				"Streamed {}/{} force Jacobians from {}: {:.3g}s waiting for reads",
+				n_loaded, time_steps, diff_cached.spill_file(), load_wait_time);
+
+		if (recompute_jacobians)
+		{
+			restore_transient_solve_state(
+				final_x_prevs, final_v_prevs, final_a_prevs,
+				diff_cached.time(time_steps) + final_dt, final_dt,
+				final_barrier_stiffness, final_friction_set, final_friction_plane_contacts);
+
+			const double backward_time = backward_timer.getElapsedTimeInSec();
+			adjoint_logger().info(
+				"Recomputed {}/{} force Jacobians in the adjoint solve: {:.3g}s ({:.1f}% of the backward sweep)",
+				n_recomputed, time_steps, recompute_time, backward_time > 0 ? 100 * recompute_time / backward_time : 0.);
+		}
+
 		return adjoints;
 	}
 
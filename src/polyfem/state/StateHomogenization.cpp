@@ -72,6 +72,9 @@ namespace polyfem
 			// Rayleigh damping form
 			args["solver"]["rayleigh_damping"]);
 
+		if (solve_data.periodic_contact_form)
+			solve_data.periodic_contact_form->set_broad_phase_margin(args["solver"]["contact"]["CCD"]["broad_phase_margin"]);
+
 		for (const auto &[name, form] : solve_data.named_forms())
 		{
 			if (name == "augmented_lagrangian_lagr" || name == "augmented_lagrangian_penalty")
@@ -328,7 +331,7 @@ namespace polyfem
 			//     solve_data.time_integrator->save_state(state_path);
 
 			// save restart file
-			save_restart_json(t0, dt, t);
+			save_restart_json(t0 + dt * t, t);
 			// stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
 		}
 	}
@@ -62,6 +62,12 @@ namespace polyfem
 		problem = ProblemFactory::factory().get_problem("Linear");
 	}
 
+	State::~State()
+	{
+		// The queued time steps read the mesh and the bases, finish them before any member is destroyed
+		output_queue.reset();
+	}
+
 	void State::init_logger(
 		const std::string &log_file,
 		const spdlog::level::level_enum log_level,
@@ -315,6 +321,9 @@ namespace polyfem
 				{
 					logger().error("Only constant barrier stiffness is supported in differentiable contact!");
 				}
+				// The shape derivative and the adjoint terms of the contact forms do not include the planes
+				if (args["contact"]["analytic_planes"])
+					log_and_throw_error("Analytic planes are not supported in differentiable contact, set /contact/analytic_planes to false!");
 			}
 
 			if (args.contains("boundary_conditions") && args["boundary_conditions"].contains("rhs"))
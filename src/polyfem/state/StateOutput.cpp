@@ -1,5 +1,10 @@
 #include <polyfem/State.hpp>
 
+#include <polyfem/io/Snapshot.hpp>
+#include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/solver/forms/Form.hpp>
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
+
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/Timer.hpp>
 
@@ -54,11 +59,29 @@ namespace polyfem
 			if (!solve_export_to_file)
 				solution_frames.emplace_back();
 
-			out_geom.save_vtu(
-				resolve_output_path(fmt::format(step_name + "{:d}.vtu", t)),
-				*this, sol, pressure, time, dt,
-				io::OutGeometryData::ExportOptions(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file),
-				is_contact_enabled(), solution_frames);
+			const std::string path = resolve_output_path(fmt::format(step_name + "{:d}.vtu", t));
+			io::OutGeometryData::ExportOptions opts(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file);
+
+			// The forces are evaluated with the forms and remeshing changes the mesh, both need the solver to wait
+			if (args["output"]["advanced"]["async"]["enabled"] && solve_export_to_file && !opts.forces && !args["space"]["remesh"]["enabled"])
+			{
+				// A single worker writes the frames in order and is the only export reading the State (mesh, bases, collision mesh),
+				// which the solver leaves untouched until wait_for_output
+				if (output_queue == nullptr)
+					output_queue = std::make_unique<io::OutputQueue>(1, args["output"]["advanced"]["async"]["max_pending"]);
+
+				// Copy everything the solver changes in the next steps
+				opts.solver_values = std::make_shared<const io::OutGeometryData::SolverValues>(solve_data);
+				const bool contact_enabled = is_contact_enabled();
+				output_queue->push([this, path, sol, pressure, time, dt, opts, contact_enabled]() {
+					std::vector<io::SolutionFrame> unused_frames;
+					out_geom.save_vtu(path, *this, sol, pressure, time, dt, opts, contact_enabled, unused_frames);
+				});
+			}
+			else
+			{
+				out_geom.save_vtu(path, *this, sol, pressure, time, dt, opts, is_contact_enabled(), solution_frames);
+			}
 
 			out_geom.save_pvd(
 				resolve_output_path(args["output"]["paraview"]["file_name"]),
@@ -175,16 +198,41 @@ namespace polyfem
 			is_contact_enabled(), solution_frames);
 	}
 
-	void State::save_restart_json(const double t0, const double dt, const int t) const
+	void State::save_restart_json(const double time, const int t)
 	{
 		const std::string restart_json_path = args["output"]["restart_json"];
-		if (restart_json_path.empty())
+		const std::string snapshot_path = args["output"]["data"]["snapshot"];
+
+		json restart_json;
+		std::string path;
+		if (!restart_json_path.empty())
+		{
+			restart_json = build_restart_json(time, t);
+			path = resolve_output_path(fmt::format(restart_json_path, t));
+		}
+
+		if (snapshot_path.empty())
+		{
+			if (!path.empty())
+			{
+				std::ofstream file(path);
+				file << restart_json;
+			}
 			return;
+		}
 
+		// The restart file is written once the snapshot it references is complete
+		if (!path.empty())
+			restart_json["input"]["data"]["snapshot"] = resolve_output_path(fmt::format(snapshot_path, t));
+		save_snapshot(t, path, restart_json);
+	}
+
+	json State::build_restart_json(const double time, const int t) const
+	{
 		json restart_json;
 		restart_json["root_path"] = root_path();
 		restart_json["common"] = root_path();
-		restart_json["time"] = {{"t0", t0 + dt * t}};
+		restart_json["time"] = {{"t0", time}};
 
 		restart_json["space"] = R"({
 			"remesh": {
@@ -260,7 +308,55 @@ namespace polyfem
 			},
 		}};
 
-		std::ofstream file(resolve_output_path(fmt::format(restart_json_path, t)));
-		file << restart_json;
+		return restart_json;
+	}
+
+	void State::save_snapshot(const int t, const std::string &restart_json_path, const json &restart_json)
+	{
+		const std::string snapshot_path = args["output"]["data"]["snapshot"];
+		if (snapshot_path.empty() || solve_data.nl_problem == nullptr)
+			return;
+
+		POLYFEM_SCOPED_TIMER("Save snapshot");
+
+		// Copy the state now, the file is written while the next steps are solved
+		auto snapshot = std::make_shared<io::Snapshot>();
+		if (solve_data.time_integrator != nullptr)
+			solve_data.time_integrator->save_snapshot(*snapshot);
+		for (const std::shared_ptr<solver::Form> &form : solve_data.nl_problem->forms())
+			form->save_snapshot(*snapshot);
+
+		wait_for_snapshot();
+
+		const std::string path = resolve_output_path(fmt::format(snapshot_path, t));
+		snapshot_writer = std::async(std::launch::async, [snapshot, path, restart_json_path, restart_json]() {
+			snapshot->write(path);
+
+			if (restart_json_path.empty())
+				return;
+			const std::string tmp_path = restart_json_path + ".tmp";
+			{
+				std::ofstream file(tmp_path);
+				file << restart_json;
+				if (!file.good())
+					log_and_throw_error("Failed to write restart file {}", tmp_path);
+			}
+			std::filesystem::rename(tmp_path, restart_json_path);
+		});
+	}
+
+	void State::wait_for_snapshot()
+	{
+		if (snapshot_writer.valid())
+			snapshot_writer.get();
+	}
+
+	void State::wait_for_output()
+	{
+		if (output_queue == nullptr)
+			return;
+
+		POLYFEM_SCOPED_TIMER("Wait for the output");
+		output_queue->wait();
 	}
 } // namespace polyfem
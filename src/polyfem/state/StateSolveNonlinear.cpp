@@ -14,10 +14,12 @@
 
 #include <polyfem/solver/NLProblem.hpp>
 #include <polyfem/solver/ALSolver.hpp>
+#include <polyfem/solver/ForcingTerm.hpp>
 #include <polyfem/solver/SolveData.hpp>
 #include <polyfem/io/MshWriter.hpp>
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/io/OutData.hpp>
+#include <polyfem/io/Snapshot.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
 #include <polyfem/utils/Timer.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
@@ -25,6 +27,9 @@
 
 #include <ipc/ipc.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace polyfem
 {
 	using namespace mesh;
@@ -33,13 +38,108 @@ namespace polyfem
 	using namespace io;
 	using namespace utils;
 
-	std::shared_ptr<polysolve::nonlinear::Solver> State::make_nl_solver(bool for_al) const
+	namespace
+	{
+		/// @brief Body id of each collision vertex, taken from the elements of its node (obstacle vertices form their own body)
+		/// @note Only for collision meshes whose vertices are the nodes (i.e., without a collision proxy)
+		Eigen::VectorXi collision_vertex_body_ids(
+			const mesh::Mesh &mesh,
+			const std::vector<basis::ElementBases> &bases,
+			const int n_bases,
+			const ipc::CollisionMesh &collision_mesh)
+		{
+			Eigen::VectorXi node_body_ids = Eigen::VectorXi::Constant(n_bases, std::numeric_limits<int>::min());
+			for (int e = 0; e < bases.size(); e++)
+				for (const basis::Basis &b : bases[e].bases)
+					for (const basis::Local2Global &l2g : b.global())
+						node_body_ids[l2g.index] = mesh.get_body_id(e);
+
+			Eigen::VectorXi body_ids(collision_mesh.num_vertices());
+			for (int i = 0; i < body_ids.size(); i++)
+				body_ids[i] = node_body_ids[collision_mesh.to_full_vertex_id(i)];
+			return body_ids;
+		}
+
+		/// @brief Set the relative tolerance of the selected iterative linear solver(s), direct solvers are left untouched
+		void set_iterative_linear_solver_tolerance(json &linear_args, const double tolerance)
+		{
+			std::vector<std::string> solvers;
+			if (linear_args["solver"].is_array())
+				solvers = linear_args["solver"].get<std::vector<std::string>>();
+			else
+				solvers.push_back(linear_args["solver"].get<std::string>());
+
+			for (const std::string &solver : solvers)
+			{
+				if (solver == "Hypre"
+					|| solver == "Eigen::ConjugateGradient"
+					|| solver == "Eigen::BiCGSTAB"
+					|| solver == "Eigen::GMRES"
+					|| solver == "Eigen::DGMRES"
+					|| solver == "Eigen::MINRES"
+					|| solver == "Eigen::LeastSquaresConjugateGradient")
+					linear_args[solver]["tolerance"] = tolerance;
+				else if (solver == "AMGCL")
+					linear_args[solver]["solver"]["tol"] = tolerance;
+			}
+		}
+
+		/// @brief Extract the number of iterations of each linear solve from the nonlinear solver info
+		json linear_solver_iterations(const json &info)
+		{
+			json iterations = json::array();
+			if (!info.contains("internal_solver") || !info["internal_solver"].is_array())
+				return iterations;
+
+			for (const json &linear_info : info["internal_solver"])
+			{
+				// AMGCL and Hypre report num_iterations, the Eigen iterative solvers solver_iter
+				if (linear_info.contains("num_iterations"))
+					iterations.push_back(linear_info["num_iterations"]);
+				else if (linear_info.contains("solver_iter"))
+					iterations.push_back(linear_info["solver_iter"]);
+			}
+			return iterations;
+		}
+
+		/// @brief Energy at x1 if the step from x0 is valid and collision free, infinity otherwise
+		/// @note Used to compare initial guesses of a time step, x0 and x1 are in the coordinates of the nonlinear problem
+		double admissible_energy(NLProblem &nl_problem, const Eigen::VectorXd &x0, const Eigen::VectorXd &x1)
+		{
+			nl_problem.line_search_begin(x0, x1);
+			double value = std::numeric_limits<double>::infinity();
+			if (nl_problem.is_step_valid(x0, x1) && nl_problem.is_step_collision_free(x0, x1))
+			{
+				nl_problem.solution_changed(x1);
+				value = nl_problem.value(x1);
+			}
+			nl_problem.line_search_end();
+			return value;
+		}
+	} // namespace
+
+	std::shared_ptr<polysolve::nonlinear::Solver> State::make_nl_solver(bool for_al, const double linear_tolerance) const
 	{
-		return polysolve::nonlinear::Solver::create(for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"], args["solver"]["linear"], units.characteristic_length(), logger());
+		json linear_args = args["solver"]["linear"];
+		if (linear_tolerance > 0)
+			set_iterative_linear_solver_tolerance(linear_args, linear_tolerance);
+
+		return polysolve::nonlinear::Solver::create(for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"], linear_args, units.characteristic_length(), logger());
 	}
 
 	void State::solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
 	{
+		if (args["time"]["adaptive"]["enabled"])
+		{
+			if (args["space"]["remesh"]["enabled"] || optimization_enabled != solver::CacheLevel::None)
+				logger().warn("Adaptive time stepping is not supported with remeshing or optimization, using a fixed time step size");
+			else
+			{
+				solve_transient_tensor_nonlinear_adaptive(time_steps, t0, dt, sol);
+				return;
+			}
+		}
+
 		init_nonlinear_tensor_solve(sol, t0 + dt);
 
 		// Write the total energy to a CSV file
@@ -57,12 +157,18 @@ namespace polyfem
 		if (optimization_enabled != solver::CacheLevel::None)
 			cache_transient_adjoint_quantities(0, sol, Eigen::MatrixXd::Zero(mesh->dimension(), mesh->dimension()));
 
+		Eigen::MatrixXd prev_sol;
+
 		for (int t = 1; t <= time_steps; ++t)
 		{
 			double forward_solve_time = 0, remeshing_time = 0, global_relaxation_time = 0;
+			solve_data.nl_problem->reset_form_timings();
 
 			{
 				POLYFEM_SCOPED_TIMER(forward_solve_time);
+				const Eigen::MatrixXd last_sol = sol;
+				predict_transient_solution(prev_sol, 1, sol, t);
+				prev_sol = last_sol;
 				solve_tensor_nonlinear(sol, t);
 			}
 
@@ -101,39 +207,221 @@ namespace polyfem
 				cache_transient_adjoint_quantities(t, sol, Eigen::MatrixXd::Zero(mesh->dimension(), mesh->dimension()));
 			}
 
-			{
-				POLYFEM_SCOPED_TIMER("Update quantities");
+			advance_time_step(sol, t0 + (t + 1) * dt, dt);
 
-				solve_data.time_integrator->update_quantities(sol);
+			logger().info("{}/{}  t={}", t, time_steps, t0 + dt * t);
 
-				solve_data.nl_problem->update_quantities(t0 + (t + 1) * dt, sol);
+			save_transient_step(t, t0 + dt * t);
+			if (remesh_enabled || args["output"]["advanced"]["save_runtime_stats"].get<bool>())
+				stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
+		}
 
-				solve_data.update_dt();
-				solve_data.update_barrier_stiffness(sol);
-			}
+		wait_for_snapshot();
+		wait_for_output();
+	}
 
-			logger().info("{}/{}  t={}", t, time_steps, t0 + dt * t);
+	void State::solve_transient_tensor_nonlinear_adaptive(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
+	{
+		const json &adaptive_args = args["time"]["adaptive"];
+		const double t_end = t0 + time_steps * dt;
+		const double min_dt = adaptive_args["min_dt_ratio"].get<double>() * dt;
+		const double max_dt = adaptive_args["max_dt_ratio"].get<double>() * dt;
+		const double error_tol = adaptive_args["error_tolerance"];
+		const int target_iterations = adaptive_args["target_newton_iterations"];
+		const double max_growth = adaptive_args["max_growth"];
+		const double shrink = adaptive_args["shrink"];
 
-			const std::string rest_mesh_path = args["output"]["data"]["rest_mesh"].get<std::string>();
-			if (!rest_mesh_path.empty())
+		init_nonlinear_tensor_solve(sol, t0 + dt);
+
+		ImplicitTimeIntegrator &time_integrator = *(solve_data.time_integrator);
+
+		EnergyCSVWriter energy_csv(resolve_output_path("energy.csv"), solve_data);
+		RuntimeStatsCSVWriter stats_csv(resolve_output_path("stats.csv"), *this, t0, dt, /*variable_dt=*/true);
+
+		// Save the initial solution
+		energy_csv.write(0, sol);
+		save_timestep(t0, 0, t0, dt, sol, Eigen::MatrixXd()); // no pressure
+
+		// Resize the current step starting at t_prev
+		const auto change_step = [&](const double t_prev, const double new_dt, const Eigen::MatrixXd &x) {
+			time_integrator.set_dt(new_dt);
+			solve_data.update_dt();
+			solve_data.nl_problem->update_quantities(t_prev + new_dt, x);
+			solve_data.update_barrier_stiffness(x);
+		};
+
+		double time = t0;
+		double step_dt = dt, prev_step_dt = dt;
+		Eigen::MatrixXd prev_sol;
+		for (int t = 1; time < t_end - 1e-12 * dt; ++t)
+		{
+			// The forms are only rebuilt between steps (collision proxy), not while a step is retried
+			NLProblem &nl_problem = *(solve_data.nl_problem);
+
+			double forward_solve_time = 0;
+			const Eigen::MatrixXd sol_prev = sol;
+
+			// Lagrange multipliers and barrier stiffness at the beginning of the step, restored when the step is rejected
+			io::Snapshot forms_state;
+			for (const std::shared_ptr<Form> &form : nl_problem.forms())
+				form->save_snapshot(forms_state);
+
+			bool accepted = false;
+			int newton_iterations = 0;
+			double error = 0;
+			while (!accepted)
 			{
-				Eigen::MatrixXd V;
-				Eigen::MatrixXi F;
-				build_mesh_matrices(V, F);
-				io::MshWriter::write(
-					resolve_output_path(fmt::format(args["output"]["data"]["rest_mesh"], t)),
-					V, F, mesh->get_body_ids(), mesh->is_volume(), /*binary=*/true);
+				nl_problem.reset_form_timings();
+				nl_problem.reset_min_max_step_size();
+
+				const size_t n_prev_info = stats.solver_info.size();
+				bool converged = true;
+				try
+				{
+					POLYFEM_SCOPED_TIMER(forward_solve_time);
+					predict_transient_solution(prev_sol, step_dt / prev_step_dt, sol, t);
+					solve_tensor_nonlinear(sol, t);
+				}
+				catch (const std::runtime_error &e)
+				{
+					logger().debug("Nonlinear solve failed at t={} with dt={}: {}", time + step_dt, step_dt, e.what());
+					// The solve can fail in the middle of a line search
+					nl_problem.line_search_end();
+					converged = false;
+				}
+
+				newton_iterations = 0;
+				for (size_t i = n_prev_info; i < stats.solver_info.size(); ++i)
+				{
+					const json &info = stats.solver_info[i];
+					if (info.contains("info") && info["info"].contains("iterations"))
+						newton_iterations += info["info"]["iterations"].get<int>();
+				}
+
+				error = converged ? time_integrator.estimate_local_error(sol) : std::numeric_limits<double>::infinity();
+				const bool at_min_dt = step_dt <= min_dt * (1 + 1e-12);
+				accepted = converged && (error_tol <= 0 || error <= error_tol || at_min_dt);
+
+				if (!accepted)
+				{
+					if (at_min_dt)
+						log_and_throw_error("Adaptive time stepping failed to converge at t={} with the minimum time step size {}", time + step_dt, min_dt);
+
+					stats.solver_info.push_back(
+						{{"type", "rejected_step"},
+						 {"t", t},
+						 {"dt", step_dt},
+						 {"error", converged ? json(error) : json(nullptr)},
+						 {"converged", converged}});
+
+					step_dt = std::max(step_dt * shrink, min_dt);
+					logger().info("Rejected step at t={}, retrying with dt={}", time, step_dt);
+
+					// Roll back to the beginning of the step, the lagged friction contacts are rebuilt from it by the next solve
+					sol = sol_prev;
+					for (const std::shared_ptr<Form> &form : nl_problem.forms())
+						form->load_snapshot(forms_state);
+					change_step(time, step_dt, sol);
+				}
 			}
 
-			const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
-			if (!state_path.empty())
-				solve_data.time_integrator->save_state(state_path);
+			time += step_dt;
 
-			// save restart file
-			save_restart_json(t0, dt, t);
-			if (remesh_enabled)
-				stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
+			energy_csv.write(t, sol);
+			save_timestep(time, t, t0, step_dt, sol, Eigen::MatrixXd()); // no pressure
+
+			// Choose the size of the next step, the local error scales with dt^(order+1)
+			double factor = max_growth;
+			if (error_tol > 0 && error > 0)
+				factor = std::min(factor, 0.9 * std::pow(error_tol / error, 1.0 / (time_integrator.order() + 1)));
+			if (target_iterations > 0 && newton_iterations > target_iterations)
+				factor = std::min(factor, double(target_iterations) / newton_iterations);
+			// Contact limited the line search: the next step is likely to run into the same contacts
+			const double min_step = nl_problem.min_max_step_size();
+			if (min_step < 1)
+				factor = std::min(factor, std::max(shrink, std::sqrt(min_step)));
+			factor = std::max(factor, shrink);
+
+			double next_dt = std::clamp(step_dt * factor, min_dt, max_dt);
+			next_dt = std::min(next_dt, std::max(t_end - time, min_dt));
+
+			prev_sol = sol_prev;
+			prev_step_dt = step_dt;
+			advance_time_step(sol, time + next_dt, next_dt);
+
+			logger().info("t={}/{}  dt={}  (newton iterations={})", time, t_end, step_dt, newton_iterations);
+
+			save_transient_step(t, time);
+			if (args["output"]["advanced"]["save_runtime_stats"].get<bool>())
+				stats_csv.write(t, time, step_dt, forward_solve_time, 0, 0, sol);
+
+			step_dt = next_dt;
+		}
+
+		wait_for_snapshot();
+		wait_for_output();
+	}
+
+	void State::predict_transient_solution(const Eigen::MatrixXd &prev_sol, const double step_ratio, Eigen::MatrixXd &sol, const int t)
+	{
+		const bool quasistatic_extrapolation = args["time"]["quasistatic"] && args["solver"]["advanced"]["quasistatic_extrapolation"] && !args["space"]["remesh"]["enabled"];
+		if (quasistatic_extrapolation && prev_sol.size() == sol.size())
+			extrapolate_quasistatic_solution(prev_sol, sol, step_ratio);
+
+		if (args["time"]["predictor"]["rank"].get<int>() > 0)
+			solve_reduced_order_predictor(sol, t);
+	}
+
+	void State::advance_time_step(Eigen::MatrixXd &sol, const double next_time, const double next_dt)
+	{
+		{
+			POLYFEM_SCOPED_TIMER("Update quantities");
+
+			// The history is updated with the size of the step just taken
+			solve_data.time_integrator->update_quantities(sol);
+			solve_data.time_integrator->update_predictor(sol);
+			solve_data.time_integrator->set_dt(next_dt);
+
+			solve_data.nl_problem->update_quantities(next_time, sol);
+			if (solve_data.al_lagr_form)
+				solve_data.al_lagr_form->accept_step(sol);
+
+			solve_data.update_dt();
+			solve_data.update_barrier_stiffness(sol);
+		}
+
+		if (!args["space"]["remesh"]["enabled"] && optimization_enabled == solver::CacheLevel::None && update_collision_proxy(sol))
+		{
+			// The pending time steps export the old collision mesh
+			wait_for_output();
+			// The forms hold references to the collision mesh, rebuild them as after remeshing
+			const json solver_info = stats.solver_info;
+			init_nonlinear_tensor_solve(sol, next_time, /*init_time_integrator=*/false);
+			stats.solver_info = solver_info;
+			solve_data.update_barrier_stiffness(sol);
+		}
+	}
+
+	void State::save_transient_step(const int t, const double time)
+	{
+		const std::string rest_mesh_path = args["output"]["data"]["rest_mesh"].get<std::string>();
+		if (!rest_mesh_path.empty())
+		{
+			Eigen::MatrixXd V;
+			Eigen::MatrixXi F;
+			build_mesh_matrices(V, F);
+			io::MshWriter::write(
+				resolve_output_path(fmt::format(args["output"]["data"]["rest_mesh"], t)),
+				V, F, mesh->get_body_ids(), mesh->is_volume(), /*binary=*/true);
 		}
+
+		const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
+		if (!state_path.empty())
+			solve_data.time_integrator->save_state(state_path);
+
+		// save restart file
+		save_restart_json(time, t);
+		stats.form_timings.push_back({{"t", t}, {"forms", solve_data.form_timings()}});
 	}
 
 	void State::init_nonlinear_tensor_solve(Eigen::MatrixXd &sol, const double t, const bool init_time_integrator)
@@ -197,6 +485,8 @@ namespace polyfem
 
 				const double dt = args["time"]["dt"];
 				solve_data.time_integrator->init(solution, velocity, acceleration, dt);
+				solve_data.time_integrator->set_predictor_parameters(
+					args["time"]["predictor"]["rank"], args["time"]["predictor"]["forgetting_factor"]);
 			}
 			assert(solve_data.time_integrator != nullptr);
 		}
@@ -261,7 +551,34 @@ namespace polyfem
 			form->set_output_dir(output_dir);
 
 		if (solve_data.contact_form != nullptr)
+		{
 			solve_data.contact_form->save_ccd_debug_meshes = args["output"]["advanced"]["save_ccd_debug_meshes"];
+			solve_data.contact_form->set_broad_phase_margin(args["solver"]["contact"]["CCD"]["broad_phase_margin"]);
+			solve_data.contact_form->set_persistent_hessian_pattern(args["solver"]["contact"]["persistent_hessian_pattern"]);
+			if (args["contact"]["analytic_planes"] && !obstacle.planes().empty())
+				solve_data.contact_form->set_planes(obstacle.planes(), obstacle.n_vertices());
+			if (args["solver"]["contact"]["CCD"]["body_culling"])
+			{
+				if (collision_mesh.full_num_vertices() == n_bases)
+					solve_data.contact_form->set_body_ids(collision_vertex_body_ids(*mesh, bases, n_bases, collision_mesh));
+				else
+					logger().warn("Body culling of the broad phase is not supported with a collision proxy, ignoring it");
+			}
+		}
+		if (solve_data.friction_form != nullptr)
+			solve_data.friction_form->set_incremental_lagging(args["solver"]["contact"]["incremental_friction_lagging"]);
+		if (solve_data.periodic_contact_form != nullptr)
+		{
+			solve_data.periodic_contact_form->set_broad_phase_margin(args["solver"]["contact"]["CCD"]["broad_phase_margin"]);
+			solve_data.periodic_contact_form->set_persistent_hessian_pattern(args["solver"]["contact"]["persistent_hessian_pattern"]);
+		}
+
+		if (args["solver"]["advanced"]["single_precision_hessian"])
+		{
+			solve_data.elastic_form->set_single_precision_hessian(true);
+			if (solve_data.damping_form != nullptr)
+				solve_data.damping_form->set_single_precision_hessian(true);
+		}
 
 		// --------------------------------------------------------------------
 		// Initialize nonlinear problems
@@ -272,11 +589,160 @@ namespace polyfem
 			*solve_data.rhs_assembler, periodic_bc, t, forms);
 		solve_data.nl_problem->init(sol);
 		solve_data.nl_problem->update_quantities(t, sol);
+		solve_data.nl_problem->set_hessian_reuse(
+			args["solver"]["advanced"]["lazy_hessian"]["max_reuse"],
+			args["solver"]["advanced"]["lazy_hessian"]["min_convergence_rate"]);
+		// The last Newton Hessian can be reused as the force Jacobian of the adjoint
+		solve_data.nl_problem->set_keep_last_hessian(
+			optimization_enabled == solver::CacheLevel::Derivatives && problem->is_time_dependent()
+			&& args["solver"]["advanced"]["adjoint_hessian_reuse_tolerance"].get<double>() >= 0);
+
+		// Only when the simulation starts, not when the forms are rebuilt (e.g., after remeshing)
+		if (init_time_integrator && !args["input"]["data"]["snapshot"].get<std::string>().empty())
+			load_snapshot(sol, t);
 		// --------------------------------------------------------------------
 
 		stats.solver_info = json::array();
 	}
 
+	void State::load_snapshot(Eigen::MatrixXd &sol, const double t)
+	{
+		POLYFEM_SCOPED_TIMER("Load snapshot");
+
+		const std::string path = resolve_input_path(args["input"]["data"]["snapshot"]);
+		logger().info("Restoring the solver state from {}", path);
+
+		io::Snapshot snapshot;
+		snapshot.read(path);
+
+		if (solve_data.time_integrator != nullptr)
+		{
+			solve_data.time_integrator->load_snapshot(snapshot);
+			if (solve_data.time_integrator->x_prev().size() != sol.size())
+				log_and_throw_error("Snapshot has {} DOFs, expected {}", solve_data.time_integrator->x_prev().size(), sol.size());
+			sol = solve_data.time_integrator->x_prev();
+			solve_data.update_dt();
+
+			solve_data.nl_problem->init(sol);
+			solve_data.nl_problem->update_quantities(t, sol);
+		}
+
+		// The forms are restored last, their update_quantities would otherwise shift the restored history
+		for (const std::shared_ptr<Form> &form : solve_data.nl_problem->forms())
+			form->load_snapshot(snapshot);
+	}
+
+	bool State::extrapolate_quasistatic_solution(const Eigen::MatrixXd &prev_sol, Eigen::MatrixXd &sol, const double step_ratio)
+	{
+		assert(solve_data.nl_problem != nullptr);
+		NLProblem &nl_problem = *(solve_data.nl_problem);
+
+		// Both candidates impose the boundary conditions of the new step, they only differ in the interior
+		const Eigen::VectorXd default_guess = nl_problem.full_to_reduced(sol);
+		const Eigen::VectorXd predicted_guess = nl_problem.full_to_reduced(sol + step_ratio * (sol - prev_sol));
+
+		const double predicted_energy = admissible_energy(nl_problem, sol, predicted_guess);
+		if (!std::isfinite(predicted_energy))
+			return false;
+		const double default_energy = admissible_energy(nl_problem, sol, default_guess);
+
+		logger().debug("Quasi-static prediction energy {:g} (previous solution {:g})", predicted_energy, default_energy);
+		if (predicted_energy >= default_energy)
+			return false;
+
+		sol = nl_problem.reduced_to_full(predicted_guess);
+		return true;
+	}
+
+	bool State::solve_reduced_order_predictor(Eigen::MatrixXd &sol, const int t)
+	{
+		assert(solve_data.time_integrator != nullptr && solve_data.nl_problem != nullptr);
+		NLProblem &nl_problem = *(solve_data.nl_problem);
+
+		const Eigen::MatrixXd &basis = solve_data.time_integrator->predictor_basis();
+		const int rank = basis.cols();
+		if (rank == 0 || basis.rows() != sol.size())
+			return false;
+
+		POLYFEM_SCOPED_TIMER("Reduced-order predictor");
+
+		// Imposing the new boundary conditions must be admissible, otherwise leave it to the AL solve
+		Eigen::VectorXd x = nl_problem.full_to_reduced(sol);
+		const double initial_energy = admissible_energy(nl_problem, sol, x);
+		if (!std::isfinite(initial_energy))
+			return false;
+
+		// Subspace directions in the reduced coordinates of the nonlinear problem
+		Eigen::MatrixXd B(x.size(), rank);
+		for (int j = 0; j < rank; ++j)
+			B.col(j) = nl_problem.full_to_reduced(sol + basis.col(j)) - x;
+
+		double current_energy = initial_energy;
+		Eigen::VectorXd grad, grad_j;
+		nl_problem.solution_changed(x);
+		nl_problem.gradient(x, grad);
+
+		const int max_iterations = args["time"]["predictor"]["iterations"];
+		int iterations = 0;
+		for (; iterations < max_iterations; ++iterations)
+		{
+			const Eigen::VectorXd reduced_grad = B.transpose() * grad;
+
+			// Hessian restricted to the subspace from finite differences of the full gradient
+			Eigen::MatrixXd reduced_hessian(rank, rank);
+			for (int j = 0; j < rank; ++j)
+			{
+				const double h = 1e-7 * std::max(1.0, x.lpNorm<Eigen::Infinity>()) / std::max(B.col(j).lpNorm<Eigen::Infinity>(), 1e-12);
+				const Eigen::VectorXd x_j = x + h * B.col(j);
+				nl_problem.solution_changed(x_j);
+				nl_problem.gradient(x_j, grad_j);
+				reduced_hessian.col(j) = B.transpose() * (grad_j - grad) / h;
+			}
+			reduced_hessian = 0.5 * (reduced_hessian + reduced_hessian.transpose()).eval();
+
+			const Eigen::LDLT<Eigen::MatrixXd> ldlt(reduced_hessian);
+			if (ldlt.info() != Eigen::Success || !ldlt.isPositive())
+				break;
+			const Eigen::VectorXd direction = B * ldlt.solve(-reduced_grad);
+
+			nl_problem.line_search_begin(x, x + direction);
+			double step = std::min(1.0, nl_problem.max_step_size(x, x + direction));
+			nl_problem.line_search_end();
+
+			bool decreased = false;
+			for (int ls = 0; ls < 10 && !decreased; ++ls, step /= 2)
+			{
+				const Eigen::VectorXd x_new = x + step * direction;
+				const double new_energy = admissible_energy(nl_problem, x, x_new);
+				if (new_energy < current_energy)
+				{
+					x = x_new;
+					current_energy = new_energy;
+					decreased = true;
+				}
+			}
+			if (!decreased)
+				break;
+
+			nl_problem.solution_changed(x);
+			nl_problem.gradient(x, grad);
+		}
+
+		stats.solver_info.push_back(
+			{{"type", "predictor"},
+			 {"t", t},
+			 {"rank", rank},
+			 {"iterations", iterations},
+			 {"energy_decrease", initial_energy - current_energy}});
+
+		if (current_energy >= initial_energy)
+			return false;
+
+		logger().debug("Reduced-order predictor (rank {}) decreased the energy by {:g} in {} iteration(s)", rank, initial_energy - current_energy, iterations);
+		sol = nl_problem.reduced_to_full(x);
+		return true;
+	}
+
 	void State::solve_tensor_nonlinear(Eigen::MatrixXd &sol, const int t, const bool init_lagging)
 	{
 		assert(solve_data.nl_problem != nullptr);
@@ -296,13 +762,27 @@ namespace polyfem
 
 		// ---------------------------------------------------------------------
 
+		// The Hessian reuse statistics are reported per subsolve
+		nl_problem.reset_hessian_reuse_info();
+
 		// Save the subsolve sequence for debugging
 		int subsolve_count = 0;
 		save_subsolve(subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 
 		// ---------------------------------------------------------------------
 
-		std::shared_ptr<polysolve::nonlinear::Solver> nl_solver = make_nl_solver(true);
+		// Inexact Newton: the tolerance of iterative linear solvers follows the nonlinear residual
+		const bool inexact_newton = args["solver"]["advanced"]["inexact_newton"]["enabled"];
+		ForcingTerm forcing_term(args["solver"]["advanced"]["inexact_newton"]);
+		const auto residual_norm = [&](const Eigen::VectorXd &reduced_sol) {
+			nl_problem.solution_changed(reduced_sol);
+			Eigen::VectorXd grad;
+			nl_problem.gradient(reduced_sol, grad);
+			return grad.norm();
+		};
+		const auto linear_tolerance = [&]() { return inexact_newton ? forcing_term.eta() : 0.0; };
+
+		std::shared_ptr<polysolve::nonlinear::Solver> nl_solver = make_nl_solver(true, linear_tolerance());
 
 		ALSolver al_solver(
 			solve_data.al_lagr_form, solve_data.al_pen_form,
@@ -314,6 +794,14 @@ namespace polyfem
 				this->solve_data.update_barrier_stiffness(sol);
 			});
 
+		al_solver.warm_start = args["solver"]["augmented_lagrangian"]["warm_start"];
+		al_solver.post_skipped_al = [&](const double predicted_error) {
+			stats.solver_info.push_back(
+				{{"type", "al_skipped"},
+				 {"t", t},
+				 {"predicted_error", predicted_error}});
+		};
+
 		al_solver.post_subsolve = [&](const double al_weight) {
 			stats.solver_info.push_back(
 				{{"type", al_weight > 0 ? "al" : "rc"},
@@ -321,13 +809,23 @@ namespace polyfem
 				 {"info", nl_solver->info()}});
 			if (al_weight > 0)
 				stats.solver_info.back()["weight"] = al_weight;
+			if (nl_problem.uses_hessian_reuse())
+			{
+				stats.solver_info.back()["hessian_reuse"] = nl_problem.hessian_reuse_info();
+				nl_problem.reset_hessian_reuse_info();
+			}
+			stats.solver_info.back()["linear_iterations"] = linear_solver_iterations(nl_solver->info());
+			if (inexact_newton)
+				stats.solver_info.back()["linear_tolerance"] = forcing_term.eta();
 			save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 		};
 
 		Eigen::MatrixXd prev_sol = sol;
 		al_solver.solve_al(nl_solver, nl_problem, sol);
 
-		nl_solver = make_nl_solver(false);
+		if (inexact_newton)
+			forcing_term.update(residual_norm(nl_problem.full_to_reduced(sol)));
+		nl_solver = make_nl_solver(false, linear_tolerance());
 		al_solver.solve_reduced(nl_solver, nl_problem, sol);
 
 		if (args["space"]["advanced"]["count_flipped_els_continuous"])
@@ -387,6 +885,11 @@ namespace polyfem
 
 				// Solve the problem with the updated lagging
 				logger().info("Lagging iteration {:d}:", lag_i + 1);
+				if (inexact_newton)
+				{
+					forcing_term.update(grad.norm());
+					nl_solver = make_nl_solver(false, linear_tolerance());
+				}
 				nl_problem.init(sol);
 				solve_data.update_barrier_stiffness(sol);
 				nl_solver->minimize(nl_problem, tmp_sol);
@@ -400,6 +903,14 @@ namespace polyfem
 					 {"t", t}, // TODO: null if static?
 					 {"lag_i", lag_i},
 					 {"info", nl_solver->info()}});
+				if (nl_problem.uses_hessian_reuse())
+				{
+					stats.solver_info.back()["hessian_reuse"] = nl_problem.hessian_reuse_info();
+					nl_problem.reset_hessian_reuse_info();
+				}
+				stats.solver_info.back()["linear_iterations"] = linear_solver_iterations(nl_solver->info());
+				if (inexact_newton)
+					stats.solver_info.back()["linear_tolerance"] = forcing_term.eta();
 				save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 			}
 		}
@@ -2,6 +2,10 @@
 
 #include <polyfem/utils/Logger.hpp>
 
+#include <Eigen/Dense>
+
+#include <cmath>
+
 namespace polyfem::time_integrator
 {
 	BDF::BDF(const int order)
@@ -122,6 +126,26 @@ namespace polyfem::time_integrator
 		return -alphas(steps() - 1)[i] / beta_dt();
 	}
 
+	double BDF::estimate_local_error(const Eigen::VectorXd &x) const
+	{
+		const int n = steps();
+
+		// Weights of the predictor p(1) in the normalized time s = (t - t^t) / dt: p(-i) = x^{t-i} for i < n and p'(0) = dt v^t
+		Eigen::MatrixXd A = Eigen::MatrixXd::Zero(n + 1, n + 1);
+		for (int i = 0; i < n; i++)
+			for (int k = 0; k <= n; k++)
+				A(i, k) = std::pow(-i, k);
+		A(n, 1) = 1;
+		const Eigen::VectorXd w = A.transpose().partialPivLu().solve(Eigen::VectorXd::Ones(n + 1));
+
+		Eigen::VectorXd prediction = w(n) * dt() * v_prev();
+		for (int i = 0; i < n; i++)
+			prediction += w(i) * x_prevs_[i];
+
+		const double beta = betas(n - 1);
+		return beta / (1 + beta) * (x - prediction).lpNorm<Eigen::Infinity>();
+	}
+
 	double BDF::beta_dt() const
 	{
 		return betas(steps() - 1) * dt();
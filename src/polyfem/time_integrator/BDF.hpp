@@ -65,6 +65,19 @@ namespace polyfem::time_integrator
 		/// @param prev_ti index of the previous solution to use (0 -> current; 1 -> previous; 2 -> second previous; etc.)
 		double dv_dx(const unsigned prev_ti = 0) const override;
 
+		/// @brief BDF with n steps is n-th order accurate (fewer steps are used until the history is filled).
+		int order() const override { return steps(); }
+
+		/// @brief Estimate the local truncation error of the step to x.
+		/// The predictor \f$p\f$ is the polynomial of degree n through the n previous solutions with slope \f$v^t\f$ at \f$x^t\f$,
+		/// its leading error term is \f$\frac{1}{n+1}\Delta t^{n+1} x^{(n+1)}\f$ while the one of BDF is \f$-\frac{\beta}{n+1}\Delta t^{n+1} x^{(n+1)}\f$, so
+		/// \f[
+		/// 	e = \frac{\beta}{1 + \beta} \|x - p\|_\infty
+		/// \f]
+		/// @param x solution at the end of the current step
+		/// @return infinity norm of the estimated local error
+		double estimate_local_error(const Eigen::VectorXd &x) const override;
+
 		/// @brief Compute \f$\beta\Delta t\f$
 		double beta_dt() const;
 
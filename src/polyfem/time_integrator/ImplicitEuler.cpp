@@ -36,4 +36,9 @@ namespace polyfem::time_integrator
 			return 0;
 		return (prev_ti == 0 ? 1 : -1) / dt();
 	}
+
+	double ImplicitEuler::estimate_local_error(const Eigen::VectorXd &x) const
+	{
+		return 0.5 * (x - (x_prev() + dt() * v_prev())).lpNorm<Eigen::Infinity>();
+	}
 } // namespace polyfem::time_integrator
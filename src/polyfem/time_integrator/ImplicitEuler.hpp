@@ -64,5 +64,17 @@ namespace polyfem::time_integrator
 		/// \f]
 		/// @param prev_ti index of the previous solution to use (0 -> current; 1 -> previous; 2 -> second previous; etc.)
 		double dv_dx(const unsigned prev_ti = 0) const override;
+
+		/// @brief Implicit Euler is first order accurate.
+		int order() const override { return 1; }
+
+		/// @brief Estimate the local truncation error of the step to x.
+		/// The explicit predictor \f$x^t + \Delta t v^t\f$ has the opposite leading error term, so
+		/// \f[
+		/// 	e = \frac{1}{2} \|x - (x^t + \Delta t v^t)\|_\infty
+		/// \f]
+		/// @param x solution at the end of the current step
+		/// @return infinity norm of the estimated local error
+		double estimate_local_error(const Eigen::VectorXd &x) const override;
 	};
 } // namespace polyfem::time_integrator
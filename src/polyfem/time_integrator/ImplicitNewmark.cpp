@@ -1,5 +1,7 @@
 #include "ImplicitNewmark.hpp"
 
+#include <cmath>
+
 namespace polyfem::time_integrator
 {
 	void ImplicitNewmark::set_parameters(const json &params)
@@ -37,6 +39,12 @@ namespace polyfem::time_integrator
 		return beta() * dt() * dt();
 	}
 
+	double ImplicitNewmark::estimate_local_error(const Eigen::VectorXd &x) const
+	{
+		const Eigen::VectorXd prediction = x_prev() + dt() * (v_prev() + 0.5 * dt() * a_prev());
+		return std::abs(beta() - 1.0 / 6.0) / beta() * (x - prediction).lpNorm<Eigen::Infinity>();
+	}
+
 	double ImplicitNewmark::dv_dx(const unsigned prev_ti) const
 	{
 		// if (i == n_steps - 1)
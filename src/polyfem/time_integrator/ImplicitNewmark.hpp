@@ -69,6 +69,19 @@ namespace polyfem::time_integrator
 
 		double da_dx(const unsigned prev_ti = 0) const;
 
+		/// @brief Newmark is second order accurate for \f$\gamma = 1/2\f$ and first order otherwise.
+		int order() const override { return gamma() == 0.5 ? 2 : 1; }
+
+		/// @brief Estimate the local truncation error of the step to x.
+		/// The Taylor predictor \f$p = x^t + \Delta t v^t + \frac{\Delta t^2}{2} a^t\f$ differs from the solution by \f$\beta \Delta t^3 x^{(3)}\f$
+		/// while the error of Newmark is \f$(\beta - \frac{1}{6}) \Delta t^3 x^{(3)}\f$, so
+		/// \f[
+		/// 	e = \frac{|\beta - 1/6|}{\beta} \|x - p\|_\infty
+		/// \f]
+		/// @param x solution at the end of the current step
+		/// @return infinity norm of the estimated local error
+		double estimate_local_error(const Eigen::VectorXd &x) const override;
+
 		/// @brief \f$\beta\f$ parameter for blending accelerations in the solution update.
 		double beta() const { return beta_; }
 		/// @brief \f$\gamma\f$ parameter for blending accelerations in the velocity update.
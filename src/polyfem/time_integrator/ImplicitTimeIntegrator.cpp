@@ -5,9 +5,13 @@
 #include <polyfem/time_integrator/BDF.hpp>
 
 #include <polyfem/io/MatrixIO.hpp>
+#include <polyfem/io/Snapshot.hpp>
 #include <polyfem/utils/StringUtils.hpp>
 #include <polyfem/utils/Logger.hpp>
 
+#include <Eigen/QR>
+#include <Eigen/SVD>
+
 #include <fstream>
 
 namespace polyfem
@@ -20,6 +24,19 @@ namespace polyfem
 			const Eigen::MatrixXd &v_prevs,
 			const Eigen::MatrixXd &a_prevs,
 			double dt)
+		{
+			set_history(x_prevs, v_prevs, a_prevs, dt);
+
+			predictor_basis_.resize(x_prevs.rows(), 0);
+			predictor_singular_values_.resize(0);
+			predictor_last_x_ = x_prevs.col(0);
+		}
+
+		void ImplicitTimeIntegrator::set_history(
+			const Eigen::MatrixXd &x_prevs,
+			const Eigen::MatrixXd &v_prevs,
+			const Eigen::MatrixXd &a_prevs,
+			double dt)
 		{
 			assert(x_prevs.cols() > 0 && x_prevs.cols() <= max_steps());
 			assert(x_prevs.cols() == v_prevs.cols());
@@ -41,6 +58,94 @@ namespace polyfem
 			dt_ = dt;
 		}
 
+		void ImplicitTimeIntegrator::set_predictor_parameters(const int rank, const double forgetting_factor)
+		{
+			assert(rank >= 0);
+			assert(forgetting_factor >= 0 && forgetting_factor <= 1);
+			predictor_rank_ = rank;
+			predictor_forgetting_factor_ = forgetting_factor;
+		}
+
+		void ImplicitTimeIntegrator::update_predictor(const Eigen::VectorXd &x)
+		{
+			if (predictor_rank_ <= 0)
+				return;
+
+			if (predictor_last_x_.size() != x.size() || predictor_basis_.rows() != x.size())
+			{
+				// The discretization changed (e.g., remeshing), restart the subspace
+				predictor_basis_.resize(x.size(), 0);
+				predictor_singular_values_.resize(0);
+				predictor_last_x_ = x;
+				return;
+			}
+
+			const Eigen::VectorXd dx = x - predictor_last_x_;
+			predictor_last_x_ = x;
+
+			const double dx_norm = dx.norm();
+			if (dx_norm == 0)
+				return;
+
+			// Brand's incremental SVD: project the increment on the current basis and
+			// diagonalize the small (r+1)x(r+1) matrix [diag(S) p; 0 rho]
+			const int r = predictor_basis_.cols();
+			Eigen::VectorXd p = predictor_basis_.transpose() * dx;
+			Eigen::VectorXd e = dx - predictor_basis_ * p;
+			// A second Gram-Schmidt pass, a single one loses orthogonality when dx is almost in the subspace
+			const Eigen::VectorXd dp = predictor_basis_.transpose() * e;
+			p += dp;
+			e -= predictor_basis_ * dp;
+			double rho = e.norm();
+			if (rho <= 1e-10 * dx_norm)
+			{
+				e.setZero();
+				rho = 0;
+			}
+			else
+				e /= rho;
+
+			Eigen::MatrixXd K = Eigen::MatrixXd::Zero(r + 1, r + 1);
+			K.topLeftCorner(r, r).diagonal() = predictor_forgetting_factor_ * predictor_singular_values_;
+			K.topRightCorner(r, 1) = p;
+			K(r, r) = rho;
+
+			const Eigen::JacobiSVD<Eigen::MatrixXd> svd(K, Eigen::ComputeFullU);
+			const Eigen::VectorXd &S = svd.singularValues();
+
+			int new_rank = 0;
+			while (new_rank < std::min(r + 1, predictor_rank_) && S(new_rank) > 1e-10 * S(0))
+				++new_rank;
+
+			Eigen::MatrixXd Q(x.size(), r + 1);
+			Q.leftCols(r) = predictor_basis_;
+			Q.col(r) = e;
+
+			predictor_basis_ = Q * svd.matrixU().leftCols(new_rank);
+			predictor_singular_values_ = S.head(new_rank);
+
+			// The rounding errors of the updates accumulate, restore an orthonormal basis of the same subspace when they become visible
+			const Eigen::MatrixXd gram = predictor_basis_.transpose() * predictor_basis_;
+			if ((gram - Eigen::MatrixXd::Identity(new_rank, new_rank)).lpNorm<Eigen::Infinity>() > 1e-10)
+				reorthonormalize_predictor();
+		}
+
+		void ImplicitTimeIntegrator::reorthonormalize_predictor()
+		{
+			const int r = predictor_basis_.cols();
+			if (r == 0)
+				return;
+
+			// basis * diag(S) = Q * R * diag(S), the SVD of the small R * diag(S) gives the new basis and singular values
+			const Eigen::HouseholderQR<Eigen::MatrixXd> qr(predictor_basis_);
+			const Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(predictor_basis_.rows(), r);
+			const Eigen::MatrixXd R = qr.matrixQR().topRows(r).triangularView<Eigen::Upper>();
+
+			const Eigen::JacobiSVD<Eigen::MatrixXd> svd(R * predictor_singular_values_.asDiagonal(), Eigen::ComputeFullU);
+			predictor_basis_ = Q * svd.matrixU();
+			predictor_singular_values_ = svd.singularValues();
+		}
+
 		void ImplicitTimeIntegrator::save_state(const std::string &state_path) const
 		{
 			assert(!state_path.empty());
@@ -63,6 +168,46 @@ namespace polyfem
 			write_matrix(state_path, "a", tmp, /*replace=*/false);
 		}
 
+		void ImplicitTimeIntegrator::save_snapshot(io::Snapshot &snapshot) const
+		{
+			const int ndof = x_prev().size();
+			const int prev_steps = x_prevs().size();
+
+			Eigen::MatrixXd x(ndof, prev_steps), v(ndof, prev_steps), a(ndof, prev_steps);
+			for (int i = 0; i < prev_steps; ++i)
+			{
+				x.col(i) = x_prevs()[i];
+				v.col(i) = v_prevs()[i];
+				a.col(i) = a_prevs()[i];
+			}
+
+			snapshot.set("time_integrator/dt", dt_);
+			snapshot.set("time_integrator/x", x);
+			snapshot.set("time_integrator/v", v);
+			snapshot.set("time_integrator/a", a);
+			snapshot.set("time_integrator/predictor_basis", predictor_basis_);
+			snapshot.set("time_integrator/predictor_singular_values", predictor_singular_values_);
+			snapshot.set("time_integrator/predictor_last_x", predictor_last_x_);
+		}
+
+		void ImplicitTimeIntegrator::load_snapshot(const io::Snapshot &snapshot)
+		{
+			const Eigen::MatrixXd &x = snapshot.get("time_integrator/x");
+			if (x.cols() == 0 || x.cols() > max_steps())
+				log_and_throw_error("Snapshot has {} previous steps, the time integrator uses at most {}", x.cols(), max_steps());
+
+			init(x, snapshot.get("time_integrator/v"), snapshot.get("time_integrator/a"), snapshot.get_scalar("time_integrator/dt"));
+
+			// init resets the predictor, restore the subspace only if it matches the current settings
+			const Eigen::MatrixXd &basis = snapshot.get("time_integrator/predictor_basis");
+			if (basis.rows() == x.rows() && basis.cols() <= predictor_rank_)
+			{
+				predictor_basis_ = basis;
+				predictor_singular_values_ = snapshot.get("time_integrator/predictor_singular_values");
+				predictor_last_x_ = snapshot.get("time_integrator/predictor_last_x");
+			}
+		}
+
 		std::shared_ptr<ImplicitTimeIntegrator> ImplicitTimeIntegrator::construct_time_integrator(const json &params)
 		{
 			const std::string type = params.is_object() ? params["type"] : params;
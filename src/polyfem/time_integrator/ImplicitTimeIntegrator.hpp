@@ -8,6 +8,11 @@
 #include <vector>
 #include <deque>
 
+namespace polyfem::io
+{
+	class Snapshot;
+} // namespace polyfem::io
+
 namespace polyfem::time_integrator
 {
 	/// Implicit time integrator of a second order ODE (equivently a system of coupled first order ODEs).
@@ -27,8 +32,17 @@ namespace polyfem::time_integrator
 		/// @param a_prev previous value(s) for the acceleration
 		/// @param dt time step size
 		/// @note Multiple previous values for x, v, and a can be provided as columns of the input matrices.
+		/// @note Resets the predictor subspace.
 		virtual void init(const Eigen::MatrixXd &x_prevs, const Eigen::MatrixXd &v_prevs, const Eigen::MatrixXd &a_prevs, double dt);
 
+		/// @brief Replace the previous values for \f$x\f$, \f$v\f$, and \f$a\f$ and the time step size, keeping the predictor subspace.
+		/// @param x_prev previous value(s) for the solution
+		/// @param v_prev previous value(s) for the velocity
+		/// @param a_prev previous value(s) for the acceleration
+		/// @param dt time step size
+		/// @note Used to revisit a step of a simulation (e.g., to recompute adjoint quantities) without losing what it learned.
+		void set_history(const Eigen::MatrixXd &x_prevs, const Eigen::MatrixXd &v_prevs, const Eigen::MatrixXd &a_prevs, double dt);
+
 		/// @brief Update the time integration quantities (i.e., \f$x\f$, \f$v\f$, and \f$a\f$).
 		/// @param x new solution vector
 		virtual void update_quantities(const Eigen::VectorXd &x) = 0;
@@ -58,10 +72,47 @@ namespace polyfem::time_integrator
 		/// @brief Access the time step size.
 		const double &dt() const { return dt_; }
 
+		/// @brief Change the time step size, keeping the history of previous values.
+		/// @param dt new time step size
+		/// @note Multi-step integrators assume a uniform step size, so their history is only an approximation after a change.
+		void set_dt(const double dt)
+		{
+			assert(dt > 0);
+			dt_ = dt;
+		}
+
+		/// @brief Order of accuracy of the integrator, the local error of a step scales with \f$\Delta t^{order+1}\f$.
+		virtual int order() const = 0;
+
+		/// @brief Estimate the local truncation error of the step to x by comparing it with an explicit predictor of the same order (Milne's device).
+		/// @param x solution at the end of the current step
+		/// @return infinity norm of the estimated local error
+		virtual double estimate_local_error(const Eigen::VectorXd &x) const = 0;
+
+		/// @brief Set up the reduced-order predictor, a low-rank subspace of the recent solution increments.
+		/// @param rank maximum dimension of the subspace (zero disables the predictor)
+		/// @param forgetting_factor scaling of the old singular values at each update (one keeps the whole history)
+		void set_predictor_parameters(const int rank, const double forgetting_factor);
+
+		/// @brief Add the increment from the last recorded solution to x to the predictor subspace (incremental SVD).
+		/// @param x new solution vector
+		void update_predictor(const Eigen::VectorXd &x);
+
+		/// @brief Orthonormal basis of the predictor subspace, one direction per column (no columns if unavailable).
+		const Eigen::MatrixXd &predictor_basis() const { return predictor_basis_; }
+
 		/// @brief Save the values of \f$x\f$, \f$v\f$, and \f$a\f$.
 		/// @param state_path path for the output file containing \f$x, v, a\f$ as hdf5
 		virtual void save_state(const std::string &state_path) const;
 
+		/// @brief Store the time step size, the history of \f$x\f$, \f$v\f$, and \f$a\f$, and the predictor subspace in a restart snapshot.
+		/// @param snapshot snapshot to write into
+		void save_snapshot(io::Snapshot &snapshot) const;
+
+		/// @brief Restore the quantities stored by save_snapshot.
+		/// @param snapshot snapshot to read from
+		void load_snapshot(const io::Snapshot &snapshot);
+
 		/// @brief Factory method for constructing implicit time integrators from the name of the integrator.
 		/// @param name name of the type of ImplicitTimeIntegrator to construct
 		/// @return new implicit time integrator of type specfied by name
@@ -103,6 +154,20 @@ namespace polyfem::time_integrator
 		/// Store the necessary previous values of the acceleration for single or multi-step integration.
 		std::deque<Eigen::VectorXd> a_prevs_;
 
+		/// Maximum dimension of the predictor subspace (zero if the predictor is disabled).
+		int predictor_rank_ = 0;
+		/// Scaling of the old singular values when a new increment is added to the predictor subspace.
+		double predictor_forgetting_factor_ = 1;
+		/// Orthonormal basis of the predictor subspace.
+		Eigen::MatrixXd predictor_basis_;
+		/// Singular values associated with the columns of predictor_basis_.
+		Eigen::VectorXd predictor_singular_values_;
+		/// Last solution added to the predictor subspace.
+		Eigen::VectorXd predictor_last_x_;
+
+		/// Replace the predictor basis by an orthonormal basis of the same subspace (with the matching singular values).
+		void reorthonormalize_predictor();
+
 		/// Convenience functions for setting the most recent previous solution.
 		void set_x_prev(const Eigen::VectorXd &x_prev) { x_prevs_.front() = x_prev; }
 		/// Convenience functions for setting the most recent previous velocity.
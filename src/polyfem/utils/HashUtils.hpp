@@ -1,11 +1,19 @@
 #pragma once
 
 #include <cstddef> // size_t
+#include <algorithm>
 #include <array>
+#include <functional>
 #include <vector>
 
 namespace polyfem::utils
 {
+	/// @brief Mix the hash h into seed (same combination as boost::hash_combine)
+	inline void hash_combine(size_t &seed, const size_t h)
+	{
+		seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
 	struct HashPair
 	{
 		template <typename T1, typename T2>
@@ -39,7 +47,7 @@ namespace polyfem::utils
 			std::hash<T> hasher;
 			size_t hash = 0;
 			for (int i : v)
-				hash ^= hasher(i) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				hash_combine(hash, hasher(i));
 			return hash;
 		}
 	};
@@ -64,7 +72,7 @@ namespace polyfem::utils
 			std::hash<T> hasher;
 			size_t hash = 0;
 			for (int i : v)
-				hash ^= hasher(i) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				hash_combine(hash, hasher(i));
 			return hash;
 		}
 	};
@@ -80,8 +88,7 @@ namespace polyfem::utils
 			for (size_t i = 0; i < matrix.size(); ++i)
 			{
 				Scalar elem = *(matrix.data() + i);
-				seed ^=
-					std::hash<Scalar>()(elem) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+				hash_combine(seed, std::hash<Scalar>()(elem));
 			}
 			return seed;
 		}
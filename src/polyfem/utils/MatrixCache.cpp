@@ -68,13 +68,36 @@ namespace polyfem::utils
 			assert(main_cache_ != this && main_cache_ != nullptr && main_cache_->main_cache_ == nullptr);
 		}
 		size_ = other.size_;
+		single_precision_ = other.single_precision_;
 
-		values_.resize(other.values_.size());
+		reset_values(other.values_size());
 
 		tmp_.resize(other.mat_.rows(), other.mat_.cols());
 		mat_.resize(other.mat_.rows(), other.mat_.cols());
 		mat_.setZero();
-		std::fill(values_.begin(), values_.end(), 0);
+	}
+
+	void SparseMatrixCache::set_single_precision(const bool val)
+	{
+		assert(mapping().empty());
+		single_precision_ = val;
+		reset_values(0);
+	}
+
+	void SparseMatrixCache::reset_values(const size_t size)
+	{
+		if (single_precision_)
+		{
+			values_.clear();
+			float_values_.resize(size);
+			std::fill(float_values_.begin(), float_values_.end(), 0);
+		}
+		else
+		{
+			float_values_.clear();
+			values_.resize(size);
+			std::fill(values_.begin(), values_.end(), 0);
+		}
 	}
 
 	void SparseMatrixCache::set_zero()
@@ -82,7 +105,7 @@ namespace polyfem::utils
 		tmp_.setZero();
 		mat_.setZero();
 
-		std::fill(values_.begin(), values_.end(), 0);
+		reset_values(values_size());
 	}
 
 	void SparseMatrixCache::add_value(const int e, const int i, const int j, const double value)
@@ -107,7 +130,10 @@ namespace polyfem::utils
 			}
 
 			// save entry directly to value buffer at the proper index
-			values_[second_cache()[e][current_e_index_]] += value;
+			if (single_precision_)
+				float_values_[second_cache()[e][current_e_index_]] += value;
+			else
+				values_[second_cache()[e][current_e_index_]] += value;
 			current_e_index_++;
 		}
 	}
@@ -142,7 +168,7 @@ namespace polyfem::utils
 			{
 				assert(main_cache_ == nullptr);
 
-				values_.resize(mat_.nonZeros());
+				reset_values(mat_.nonZeros());
 				inner_index_.resize(mat_.nonZeros());
 				outer_index_.resize(mat_.rows() + 1);
 				mapping_.resize(mat_.rows());
@@ -194,7 +220,7 @@ namespace polyfem::utils
 							// match columns
 							if (p.first == j)
 							{
-								assert(p.second < values_.size());
+								assert(p.second < values_size());
 								index = p.second;
 								break;
 							}
@@ -217,14 +243,24 @@ namespace polyfem::utils
 			const auto &outer_index = main_cache()->outer_index_;
 			const auto &inner_index = main_cache()->inner_index_;
 			// directly write the values to the matrix
-			mat_ = Eigen::Map<const StiffnessMatrix>(
-				size_, size_, values_.size(), &outer_index[0], &inner_index[0], &values_[0]);
+			if (single_precision_)
+			{
+				typedef Eigen::SparseMatrix<float, Eigen::ColMajor, StiffnessMatrix::StorageIndex> FloatStiffnessMatrix;
+				mat_ = Eigen::Map<const FloatStiffnessMatrix>(
+						   size_, size_, float_values_.size(), &outer_index[0], &inner_index[0], &float_values_[0])
+						   .cast<double>();
+			}
+			else
+			{
+				mat_ = Eigen::Map<const StiffnessMatrix>(
+					size_, size_, values_.size(), &outer_index[0], &inner_index[0], &values_[0]);
+			}
 
 			current_e_ = -1;
 			current_e_index_ = -1;
 
 		}
-		std::fill(values_.begin(), values_.end(), 0);
+		reset_values(values_size());
 		return mat_;
 	}
 
@@ -268,14 +304,27 @@ namespace polyfem::utils
 			const auto &ainner_index = a.main_cache()->inner_index_;
 			assert(ainner_index.size() == inner_index.size());
 			assert(aouter_index.size() == outer_index.size());
-			assert(a.values_.size() == values_.size());
+			assert(a.values_size() == values_size());
+			assert(a.single_precision_ == single_precision_);
 
-			maybe_parallel_for(a.values_.size(), [&](int start, int end, int thread_id) {
-				for (int i = start; i < end; ++i)
-				{
-					out->values_[i] = a.values_[i] + values_[i];
-				}
-			});
+			if (single_precision_)
+			{
+				maybe_parallel_for(a.float_values_.size(), [&](int start, int end, int thread_id) {
+					for (int i = start; i < end; ++i)
+					{
+						out->float_values_[i] = a.float_values_[i] + float_values_[i];
+					}
+				});
+			}
+			else
+			{
+				maybe_parallel_for(a.values_.size(), [&](int start, int end, int thread_id) {
+					for (int i = start; i < end; ++i)
+					{
+						out->values_[i] = a.values_[i] + values_[i];
+					}
+				});
+			}
 		}
 
 		return out;
@@ -311,14 +360,27 @@ namespace polyfem::utils
 			const auto &oinner_index = o.main_cache()->inner_index_;
 			assert(inner_index.size() == oinner_index.size());
 			assert(outer_index.size() == oouter_index.size());
-			assert(values_.size() == o.values_.size());
+			assert(values_size() == o.values_size());
+			assert(single_precision_ == o.single_precision_);
 
-			maybe_parallel_for(o.values_.size(), [&](int start, int end, int thread_id) {
-				for (int i = start; i < end; ++i)
-				{
-					values_[i] += o.values_[i];
-				}
-			});
+			if (single_precision_)
+			{
+				maybe_parallel_for(o.float_values_.size(), [&](int start, int end, int thread_id) {
+					for (int i = start; i < end; ++i)
+					{
+						float_values_[i] += o.float_values_[i];
+					}
+				});
+			}
+			else
+			{
+				maybe_parallel_for(o.values_.size(), [&](int start, int end, int thread_id) {
+					for (int i = start; i < end; ++i)
+					{
+						values_[i] += o.values_[i];
+					}
+				});
+			}
 		}
 	}
 
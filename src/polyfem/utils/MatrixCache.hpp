@@ -72,11 +72,17 @@ namespace polyfem::utils
 		inline void reserve(const size_t size) override { entries_.reserve(size); }
 		inline size_t entries_size() const override { return entries_.size(); }
 		inline size_t capacity() const override { return entries_.capacity(); }
-		inline size_t non_zeros() const override { return mapping_.empty() ? mat_.nonZeros() : values_.size(); }
+		inline size_t non_zeros() const override { return mapping_.empty() ? mat_.nonZeros() : values_size(); }
 		inline size_t triplet_count() const override { return entries_.size() + mat_.nonZeros(); }
 		inline bool is_sparse() const override { return true; }
 		inline size_t mapping_size() const { return mapping_.size(); }
 
+		/// store the cached values in single precision (halves the memory and bandwidth of the value buffers)
+		/// the assembled matrix returned by get_matrix is still in double precision
+		/// must be called before the cache is constructed
+		void set_single_precision(const bool val);
+		inline bool is_single_precision() const { return single_precision_; }
+
 		/// e = element_index, i = global row_index, j = global column_index, value = value to add to matrix
 		/// if the cache is yet to be constructed, save the row, column, and value to be added to the second cache
 		///     in this case, modifies_ entries_ and second_cache_entries_
@@ -110,6 +116,8 @@ namespace polyfem::utils
 		std::vector<std::vector<std::pair<int, size_t>>> mapping_; ///< maps row indices to column index/local index pairs
 		std::vector<int> inner_index_, outer_index_; ///< saves inner/outer indices for sparse matrix
 		std::vector<double> values_; ///< buffer for values (corresponds to inner/outer_index_ structure for sparse matrix)
+		std::vector<float> float_values_; ///< single precision buffer for values, used instead of values_ if single_precision_
+		bool single_precision_ = false;
 		const SparseMatrixCache *main_cache_ = nullptr;
 
 		std::vector<std::vector<int>> second_cache_; ///< maps element index to local index
@@ -131,6 +139,14 @@ namespace polyfem::utils
 		{
 			return main_cache()->second_cache_;
 		}
+
+		inline size_t values_size() const
+		{
+			return single_precision_ ? float_values_.size() : values_.size();
+		}
+
+		/// resize the active value buffer and set it to zero
+		void reset_values(const size_t size);
 	};
 
 	class DenseMatrixCache : public MatrixCache
@@ -11,6 +11,9 @@
 #include <igl/writePLY.h>
 #include <igl/boundary_facets.h>
 
+#include <algorithm>
+#include <map>
+
 namespace
 {
 	std::shared_ptr<polyfem::State> get_state(const std::string mesh_path = "", const int discr_order = 4)
@@ -166,4 +169,71 @@ TEST_CASE("build collision proxy displacement map", "[build_collision_proxy]")
 		displacement_map_entries);
 
 	CHECK(displacement_map_entries.size() == vertices.rows() * n_nodes_per_element);
-}
\ No newline at end of file
+}
+TEST_CASE("collision proxy refined near obstacles", "[build_collision_proxy]")
+{
+	using namespace polyfem::mesh;
+
+	const auto state = get_state();
+
+	Eigen::MatrixXd V;
+	Eigen::MatrixXi T;
+	state->build_mesh_matrices(V, T);
+
+	// Single obstacle vertex just right of the sphere
+	Eigen::MatrixXd obstacle_vertex = V.colwise().mean();
+	obstacle_vertex(0) = V.col(0).maxCoeff() + 0.01;
+
+	const auto count_refined = [](const std::vector<std::vector<bool>> &refined_faces) {
+		int n_refined = 0, n_faces = 0;
+		for (const std::vector<bool> &faces : refined_faces)
+		{
+			n_refined += std::count(faces.begin(), faces.end(), true);
+			n_faces += faces.size();
+		}
+		return std::make_pair(n_refined, n_faces);
+	};
+
+	const auto select = [&](const double distance) {
+		return select_collision_proxy_refined_faces(
+			state->bases, state->geom_bases(), state->total_local_boundary, /*body_ids=*/{},
+			obstacle_vertex, Eigen::MatrixXi(), distance);
+	};
+
+	const std::vector<std::vector<bool>> refined_faces = select(0.1);
+	const auto [n_refined, n_faces] = count_refined(refined_faces);
+	CHECK(n_refined > 0);
+	CHECK(n_refined < n_faces);
+	CHECK(count_refined(select(10)).first == n_faces);
+	CHECK(count_refined(select(0)).first == 0);
+
+	Eigen::MatrixXd proxy_vertices;
+	Eigen::MatrixXi proxy_faces;
+	std::vector<Eigen::Triplet<double>> displacement_map_entries;
+	build_collision_proxy(
+		state->bases, state->geom_bases(), state->total_local_boundary, state->n_bases, state->mesh->dimension(),
+		/*max_edge_length=*/0.1, proxy_vertices, proxy_faces, displacement_map_entries,
+		CollisionProxyTessellation::REGULAR, refined_faces);
+
+	// Coarser than the fully refined proxy
+	CHECK(proxy_faces.rows() > n_faces);
+	CHECK(proxy_faces.rows() < 2430);
+
+	// The refined and coarse faces are conforming: the proxy of the sphere stays a closed manifold
+	std::map<std::pair<int, int>, int> edge_count;
+	for (int f = 0; f < proxy_faces.rows(); f++)
+		for (int i = 0; i < 3; i++)
+		{
+			const int a = proxy_faces(f, i), b = proxy_faces(f, (i + 1) % 3);
+			++edge_count[std::minmax(a, b)];
+		}
+	for (const auto &[edge, count] : edge_count)
+		CHECK(count == 2);
+	CHECK(proxy_vertices.rows() - int(edge_count.size()) + proxy_faces.rows() == 2);
+
+	// The displacement map interpolates the nodes
+	Eigen::SparseMatrix<double> W(proxy_vertices.rows(), state->n_bases);
+	W.setFromTriplets(displacement_map_entries.begin(), displacement_map_entries.end());
+	const Eigen::VectorXd row_sums = W * Eigen::VectorXd::Ones(state->n_bases);
+	CHECK(row_sums.isApprox(Eigen::VectorXd::Ones(proxy_vertices.rows())));
+}
@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////////////////////////
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/solver/forms/FrictionForm.hpp>
+#include <polyfem/solver/forms/PeriodicContactForm.hpp>
+
+#include <ipc/collision_mesh.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace polyfem;
+using namespace polyfem::solver;
+
+namespace
+{
+	const double dhat = 0.1;
+
+	/// Two horizontal edges (one per body), a unit one at height gap above the middle of a longer one
+	/// @note Only the top vertices are close to the other edge, their closest points are inside the bottom edge
+	ipc::CollisionMesh two_edges_mesh(const double gap)
+	{
+		Eigen::MatrixXd V(4, 2);
+		V << -1, 0,
+			2, 0,
+			0, gap,
+			1, gap;
+		Eigen::MatrixXi E(2, 2);
+		E << 0, 1,
+			2, 3;
+		return ipc::CollisionMesh(V, E, Eigen::MatrixXi());
+	}
+
+	/// Solution moving the top edge of two_edges_mesh vertically by dy
+	Eigen::VectorXd move_top_edge(const double dy)
+	{
+		Eigen::VectorXd x = Eigen::VectorXd::Zero(8);
+		x(5) = dy;
+		x(7) = dy;
+		return x;
+	}
+
+	std::shared_ptr<ContactForm> make_contact_form(const ipc::CollisionMesh &collision_mesh)
+	{
+		auto form = std::make_shared<ContactForm>(
+			collision_mesh, dhat, /*avg_mass=*/1,
+			/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+			/*is_time_dependent=*/false, /*enable_shape_derivatives=*/false,
+			ipc::BroadPhaseMethod::HASH_GRID, /*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/1e6);
+		form->set_barrier_stiffness(1);
+		return form;
+	}
+} // namespace
+
+TEST_CASE("contact form collision set memoization", "[form][contact_form]")
+{
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(dhat / 2);
+	const Eigen::VectorXd x_near = move_top_edge(0);
+	const Eigen::VectorXd x_far = move_top_edge(1);
+
+	const auto form0 = make_contact_form(collision_mesh);
+	const auto form1 = make_contact_form(collision_mesh);
+
+	// Each form caches its own collision set, even for the same mesh and solution
+	form0->init(x_near);
+	form1->init(x_near);
+	CHECK(!form0->collision_set().empty());
+	CHECK(form1->collision_set().size() == form0->collision_set().size());
+
+	form1->solution_changed(x_far);
+	CHECK(form1->collision_set().empty());
+	CHECK(!form0->collision_set().empty());
+
+	// The cache follows the solution back and forth
+	form1->solution_changed(x_near);
+	CHECK(form1->collision_set().size() == form0->collision_set().size());
+	form0->solution_changed(x_far);
+	form0->solution_changed(x_far);
+	CHECK(form0->collision_set().empty());
+}
+
+TEST_CASE("contact form broad phase margin", "[form][contact_form]")
+{
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(2 * dhat);
+
+	// The candidates are kept while the surface moves less than 5 dhat
+	const auto form = make_contact_form(collision_mesh);
+	form->set_broad_phase_margin(5);
+	const auto reference_form = make_contact_form(collision_mesh);
+
+	const Eigen::VectorXd x0 = move_top_edge(0);
+	for (const auto &f : {form, reference_form})
+	{
+		f->init(x0);
+		f->line_search_begin(x0, move_top_edge(-dhat / 2));
+		f->line_search_end();
+	}
+	CHECK(form->collision_set().empty());
+
+	// Within the margin: the kept candidates give the same collision set and step sizes
+	const Eigen::VectorXd x1 = move_top_edge(-1.5 * dhat);
+	form->solution_changed(x1);
+	reference_form->solution_changed(x1);
+	CHECK(!form->collision_set().empty());
+	CHECK(form->collision_set().size() == reference_form->collision_set().size());
+
+	const Eigen::VectorXd x2 = move_top_edge(-4 * dhat);
+	const double max_step = form->max_step_size(x1, x2);
+	CHECK(max_step < 1);
+	CHECK(max_step == Catch::Approx(reference_form->max_step_size(x1, x2)));
+	CHECK(!form->is_step_collision_free(x1, x2));
+	CHECK(form->is_step_collision_free(x1, x1 + 0.5 * max_step * (x2 - x1)));
+
+	// Outside of the margin: the candidates are rebuilt
+	const Eigen::VectorXd x3 = move_top_edge(1);
+	form->line_search_begin(x3, x2);
+	reference_form->line_search_begin(x3, x2);
+	CHECK(form->max_step_size(x3, x2) == Catch::Approx(reference_form->max_step_size(x3, x2)));
+	form->line_search_end();
+	reference_form->line_search_end();
+}
+
+TEST_CASE("contact form candidates time of impact", "[form][contact_form]")
+{
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(2 * dhat);
+	const auto form = make_contact_form(collision_mesh);
+
+	const Eigen::VectorXd x0 = move_top_edge(0);
+	form->init(x0);
+
+	SECTION("Colliding motion")
+	{
+		// The top edge crosses the bottom one at a fifth of the motion
+		const Eigen::VectorXd x1 = move_top_edge(-10 * dhat);
+		form->line_search_begin(x0, x1);
+		const double max_step = form->max_step_size(x0, x1);
+		CHECK(max_step > 0);
+		CHECK(max_step < 0.2);
+
+		const std::vector<double> &toi = form->candidates_toi();
+		REQUIRE(!toi.empty());
+		CHECK(*std::min_element(toi.begin(), toi.end()) == Catch::Approx(max_step));
+
+		// Fractions of the same motion are pruned with the times of impact
+		for (const double alpha : {0.5 * max_step, max_step, 0.3, 1.0})
+		{
+			CAPTURE(alpha);
+			CHECK(form->is_step_collision_free(x0, x0 + alpha * (x1 - x0)) == (alpha <= max_step));
+		}
+		form->line_search_end();
+	}
+
+	SECTION("Collision free motion")
+	{
+		const Eigen::VectorXd x1 = move_top_edge(-dhat);
+		form->line_search_begin(x0, x1);
+		CHECK(form->max_step_size(x0, x1) == 1);
+		for (const double toi : form->candidates_toi())
+			CHECK(toi == 1);
+		CHECK(form->is_step_collision_free(x0, x1));
+		form->line_search_end();
+	}
+}
+
+TEST_CASE("contact form persistent hessian pattern", "[form][contact_form]")
+{
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(dhat / 2);
+
+	// Pairs within 2 dhat are part of the pattern
+	const auto form = make_contact_form(collision_mesh);
+	form->set_persistent_hessian_pattern(1);
+	const auto reference_form = make_contact_form(collision_mesh);
+
+	const Eigen::VectorXd x_near = move_top_edge(0);
+	form->init(x_near);
+	form->update_quantities(0, x_near);
+	reference_form->init(x_near);
+	CHECK(form->hessian_pattern().nonZeros() > 0);
+
+	StiffnessMatrix hessian_near, reference_hessian;
+	form->second_derivative(x_near, hessian_near);
+	reference_form->second_derivative(x_near, reference_hessian);
+	CHECK(Eigen::MatrixXd(hessian_near).isApprox(Eigen::MatrixXd(reference_hessian)));
+
+	// The pairs leave the collision set but keep their entries
+	const Eigen::VectorXd x_mid = move_top_edge(dhat);
+	form->solution_changed(x_mid);
+	CHECK(form->collision_set().empty());
+
+	StiffnessMatrix hessian_mid;
+	form->second_derivative(x_mid, hessian_mid);
+	hessian_near.makeCompressed();
+	hessian_mid.makeCompressed();
+	REQUIRE(hessian_mid.nonZeros() == hessian_near.nonZeros());
+	CHECK(std::equal(hessian_mid.outerIndexPtr(), hessian_mid.outerIndexPtr() + hessian_mid.outerSize() + 1, hessian_near.outerIndexPtr()));
+	CHECK(std::equal(hessian_mid.innerIndexPtr(), hessian_mid.innerIndexPtr() + hessian_mid.nonZeros(), hessian_near.innerIndexPtr()));
+	CHECK(Eigen::MatrixXd(hessian_mid).isZero());
+}
+
+TEST_CASE("incremental friction lagging", "[form][friction_form]")
+{
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(dhat / 2);
+	const auto contact_form = make_contact_form(collision_mesh);
+
+	const auto make_friction_form = [&](const bool incremental) {
+		auto form = std::make_shared<FrictionForm>(
+			collision_mesh, nullptr, /*epsv=*/1e-3, /*mu=*/0.5, ipc::BroadPhaseMethod::HASH_GRID,
+			*contact_form, /*n_lagging_iters=*/-1);
+		form->set_incremental_lagging(incremental);
+		return form;
+	};
+	const auto incremental_form = make_friction_form(true);
+	const auto full_form = make_friction_form(false);
+
+	const Eigen::VectorXd x0 = move_top_edge(0);
+	contact_form->init(x0);
+	incremental_form->init_lagging(x0);
+	full_form->init_lagging(x0);
+	const ipc::FrictionCollisions initial_collisions = incremental_form->friction_collision_set();
+	REQUIRE(initial_collisions.size() > 0);
+
+	// Same pairs: only the normal forces are updated, the closest points stay lagged
+	Eigen::VectorXd x1 = move_top_edge(-dhat / 10);
+	x1(4) = x1(6) = 0.1;
+	contact_form->solution_changed(x1);
+	incremental_form->update_lagging(x1, 1);
+	full_form->update_lagging(x1, 1);
+
+	const ipc::FrictionCollisions &incremental_collisions = incremental_form->friction_collision_set();
+	const ipc::FrictionCollisions &full_collisions = full_form->friction_collision_set();
+	REQUIRE(incremental_collisions.size() == full_collisions.size());
+	for (size_t i = 0; i < incremental_collisions.size(); i++)
+	{
+		CHECK(incremental_collisions[i].normal_force_magnitude == Catch::Approx(full_collisions[i].normal_force_magnitude));
+		CHECK(incremental_collisions[i].normal_force_magnitude > initial_collisions[i].normal_force_magnitude);
+		CHECK(incremental_collisions[i].closest_point == initial_collisions[i].closest_point);
+	}
+
+	// Different pairs: the lagged collisions are rebuilt
+	const Eigen::VectorXd x2 = move_top_edge(1);
+	contact_form->solution_changed(x2);
+	incremental_form->update_lagging(x2, 2);
+	CHECK(incremental_form->friction_collision_set().empty());
+}
+
+TEST_CASE("contact form body culling", "[form][contact_form]")
+{
+	SECTION("Same contacts between bodies")
+	{
+		const ipc::CollisionMesh collision_mesh = two_edges_mesh(dhat / 2);
+		const auto form = make_contact_form(collision_mesh);
+		form->set_body_ids((Eigen::VectorXi(4) << 0, 0, 1, 1).finished());
+		const auto reference_form = make_contact_form(collision_mesh);
+
+		const Eigen::VectorXd x0 = move_top_edge(0);
+		form->init(x0);
+		reference_form->init(x0);
+		CHECK(!form->collision_set().empty());
+		CHECK(form->collision_set().size() == reference_form->collision_set().size());
+		CHECK(form->value(x0) == Catch::Approx(reference_form->value(x0)));
+
+		const Eigen::VectorXd x1 = move_top_edge(-dhat);
+		CHECK(form->max_step_size(x0, x1) == Catch::Approx(reference_form->max_step_size(x0, x1)));
+		CHECK(form->is_step_collision_free(x0, x1) == reference_form->is_step_collision_free(x0, x1));
+	}
+
+	SECTION("Bodies far apart")
+	{
+		// Two close edges of body 0 and a far edge of body 1
+		Eigen::MatrixXd V(6, 2);
+		V << -1, 0,
+			2, 0,
+			0, dhat / 2,
+			1, dhat / 2,
+			0, 10,
+			1, 10;
+		Eigen::MatrixXi E(3, 2);
+		E << 0, 1,
+			2, 3,
+			4, 5;
+		const ipc::CollisionMesh collision_mesh(V, E, Eigen::MatrixXi());
+
+		const auto form = make_contact_form(collision_mesh);
+		form->set_body_ids((Eigen::VectorXi(6) << 0, 0, 0, 0, 1, 1).finished());
+		const auto reference_form = make_contact_form(collision_mesh);
+
+		const Eigen::VectorXd x = Eigen::VectorXd::Zero(V.size());
+		form->init(x);
+		reference_form->init(x);
+
+		// The self contact within a body is ignored
+		CHECK(form->collision_set().empty());
+		CHECK(!reference_form->collision_set().empty());
+	}
+}
+
+TEST_CASE("periodic contact form candidates cache", "[form][contact_form]")
+{
+	// Single cell without tiling: [fluctuation of the 4 vertices, macro strain]
+	const ipc::CollisionMesh collision_mesh = two_edges_mesh(2 * dhat);
+	const Eigen::VectorXi tiled_to_single = Eigen::VectorXi::LinSpaced(4, 0, 3);
+
+	const auto make_periodic_form = [&](const double margin) {
+		auto form = std::make_shared<PeriodicContactForm>(
+			collision_mesh, tiled_to_single, dhat, /*avg_mass=*/1,
+			/*use_convergent_formulation=*/false, /*use_adaptive_barrier_stiffness=*/false,
+			/*is_time_dependent=*/false, /*enable_shape_derivatives=*/false,
+			ipc::BroadPhaseMethod::HASH_GRID, /*ccd_tolerance=*/1e-6, /*ccd_max_iterations=*/1e6);
+		form->set_barrier_stiffness(1);
+		form->set_broad_phase_margin(margin);
+		return form;
+	};
+	const auto form = make_periodic_form(5);
+	const auto reference_form = make_periodic_form(0);
+
+	const auto with_strain = [](Eigen::VectorXd x, const double strain_yy) {
+		x(11) = strain_yy;
+		return x;
+	};
+
+	// Small fluctuation and macro strain steps (within the margin), then a large colliding one
+	Eigen::VectorXd x_top_down(12);
+	x_top_down << move_top_edge(-dhat / 2), Eigen::VectorXd::Zero(4);
+	Eigen::VectorXd x_collide(12);
+	x_collide << move_top_edge(-10 * dhat), Eigen::VectorXd::Zero(4);
+	const std::vector<Eigen::VectorXd> xs = {
+		Eigen::VectorXd::Zero(12),
+		x_top_down,
+		with_strain(x_top_down, -0.25),
+		with_strain(x_top_down, -0.5),
+		x_collide};
+
+	form->init(xs[0]);
+	reference_form->init(xs[0]);
+	for (int i = 1; i < xs.size(); i++)
+	{
+		CAPTURE(i);
+		form->line_search_begin(xs[i - 1], xs[i]);
+		reference_form->line_search_begin(xs[i - 1], xs[i]);
+
+		const double max_step = form->max_step_size(xs[i - 1], xs[i]);
+		CHECK(max_step == Catch::Approx(reference_form->max_step_size(xs[i - 1], xs[i])));
+		if (i == xs.size() - 1)
+			CHECK(max_step < 1);
+
+		const Eigen::VectorXd x = xs[i - 1] + max_step * (xs[i] - xs[i - 1]);
+		form->solution_changed(x);
+		reference_form->solution_changed(x);
+		CHECK(form->collision_set().size() == reference_form->collision_set().size());
+		CHECK(form->value(x) == Catch::Approx(reference_form->value(x)));
+
+		form->line_search_end();
+		reference_form->line_search_end();
+	}
+}
@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include <polyfem/State.hpp>
+#include <polyfem/solver/DiffCache.hpp>
 #include <polyfem/solver/Optimizations.hpp>
 #include <polyfem/solver/AdjointTools.hpp>
 
@@ -13,8 +14,10 @@
 #include <polyfem/solver/forms/parametrization/Parametrizations.hpp>
 #include <polyfem/solver/forms/parametrization/NodeCompositeParametrizations.hpp>
 #include <polyfem/solver/AdjointNLProblem.hpp>
+#include <polyfem/utils/par_for.hpp>
 
 #include <catch2/catch_all.hpp>
+#include <filesystem>
 #include <math.h>
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -895,6 +898,96 @@ TEST_CASE("shape-contact", "[test_adjoint]")
 	verify_adjoint(*nl_problem, x, one_form.normalized(), 1e-7, 1e-5);
 }
 
+TEST_CASE("static adjoint factorization reuse", "[test_adjoint]")
+{
+	json opt_args, ref_opt_args;
+	load_json(append_root_path("shape-contact-opt.json"), opt_args);
+	ref_opt_args = opt_args;
+	auto [obj, var2sim, states] = prepare_test(opt_args);
+	auto [ref_obj, ref_var2sim, ref_states] = prepare_test(ref_opt_args);
+	State &state = *states[0];
+	State &reference = *ref_states[0];
+
+	// Same pattern, different values
+	const auto scale_and_solve = [](State &s, const double scale) {
+		Eigen::MatrixXd V;
+		s.get_vertices(V);
+		for (int v = 0; v < V.rows(); ++v)
+			s.set_mesh_vertex(v, scale * V.row(v).transpose());
+		s.build_basis();
+		s.assemble_rhs();
+		s.assemble_mass_mat();
+		Eigen::MatrixXd sol, pressure;
+		s.solve_problem(sol, pressure);
+	};
+
+	scale_and_solve(state, 1);
+	const Eigen::MatrixXd rhs = Eigen::MatrixXd::Random(state.ndof(), 2);
+	const Eigen::MatrixXd adjoint = state.solve_adjoint(rhs);
+	CHECK((state.solve_adjoint(rhs) - adjoint).norm() <= 1e-12 * adjoint.norm());
+
+	// The cached factorization is updated, the adjoint matches the one of a state that never solved an adjoint
+	scale_and_solve(state, 1.01);
+	scale_and_solve(reference, 1.01);
+	const Eigen::MatrixXd ref_adjoint = reference.solve_adjoint(rhs);
+	CHECK((ref_adjoint - adjoint).norm() > 1e-6 * adjoint.norm());
+	CHECK((state.solve_adjoint(rhs) - ref_adjoint).norm() <= 1e-6 * ref_adjoint.norm());
+}
+
+TEST_CASE("parallel adjoint solves", "[test_adjoint]")
+{
+	const auto gradient = [](const int n_states, const bool solve_in_parallel) {
+		json opt_args;
+		load_json(append_root_path("shape-contact-opt.json"), opt_args);
+		// Copies of the state driven by the same shape variable, only the first one is in the objective
+		std::vector<int> state_ids = {0};
+		for (int i = 1; i < n_states; ++i)
+		{
+			opt_args["states"].push_back(opt_args["states"][0]);
+			state_ids.push_back(i);
+		}
+		opt_args["variable_to_simulation"][0]["state"] = state_ids;
+		opt_args["solver"]["advanced"]["solve_in_parallel"] = solve_in_parallel;
+
+		auto [obj, var2sim, states] = prepare_test(opt_args);
+		var2sim.set_solve_in_parallel(solve_in_parallel);
+		AdjointNLProblem nl_problem(obj, var2sim, states, opt_args);
+
+		Eigen::MatrixXd V;
+		states[0]->get_vertices(V);
+		const Eigen::VectorXd x = utils::flatten(V);
+		nl_problem.solution_changed(x);
+
+		Eigen::VectorXd grad;
+		nl_problem.gradient(x, grad);
+		return grad;
+	};
+
+	const Eigen::VectorXd reference = gradient(1, false);
+	const Eigen::VectorXd serial = gradient(3, false);
+	const Eigen::VectorXd parallel = gradient(3, true);
+
+	REQUIRE(serial.size() == reference.size());
+	REQUIRE(parallel.size() == reference.size());
+	CHECK((serial - reference).norm() <= 1e-8 * reference.norm());
+	// The per-state terms are summed in state order, the forward solves only differ by the assembly threads
+	CHECK((parallel - serial).norm() <= 1e-8 * serial.norm());
+}
+
+TEST_CASE("shape-contact-analytic-planes", "[test_adjoint]")
+{
+	json opt_args;
+	load_json(append_root_path("shape-contact-opt.json"), opt_args);
+
+	json state_args;
+	REQUIRE(load_json(append_root_path(opt_args["states"][0]["path"]), state_args));
+	state_args["contact"]["enabled"] = true;
+	state_args["contact"]["analytic_planes"] = true;
+
+	// The adjoint terms do not include the analytic planes
+	CHECK_THROWS(AdjointOptUtils::create_state(state_args, solver::CacheLevel::Derivatives, -1));
+}
+
 TEST_CASE("node-trajectory", "[test_adjoint]")
 {
 	const std::string path = POLYFEM_DATA_DIR + std::string("/differentiable/input/");
@@ -1006,6 +1099,41 @@ TEST_CASE("shape-transient-friction", "[test_adjoint]")
 	verify_adjoint(*nl_problem, x, velocity_discrete, 1e-6, 1e-5);
 }
 
+TEST_CASE("transient adjoint terms thread count", "[test_adjoint]")
+{
+	json opt_args;
+	load_json(append_root_path("shape-transient-friction-opt.json"), opt_args);
+	auto [obj, var2sim, states] = prepare_test(opt_args);
+	auto nl_problem = std::make_shared<AdjointNLProblem>(obj, var2sim, states, opt_args);
+	const State &state = *states[0];
+
+	Eigen::MatrixXd V;
+	state.get_vertices(V);
+	const Eigen::VectorXd x = utils::flatten(V);
+	nl_problem->solution_changed(x);
+	Eigen::VectorXd grad;
+	nl_problem->gradient(x, grad); // solves and caches the adjoint
+
+	const auto adjoint_terms = [&]() {
+		Eigen::VectorXd shape_term, friction_term;
+		AdjointTools::dJ_shape_transient_adjoint_term(state, state.get_adjoint_mat(1), state.get_adjoint_mat(0), shape_term);
+		AdjointTools::dJ_friction_transient_adjoint_term(state, state.get_adjoint_mat(1), state.get_adjoint_mat(0), friction_term);
+		return std::make_pair(shape_term, friction_term);
+	};
+
+	const int n_threads = utils::get_n_threads();
+	utils::NThread::get().set_num_threads(1);
+	const auto [serial_shape, serial_friction] = adjoint_terms();
+	utils::NThread::get().set_num_threads(n_threads);
+	const auto [parallel_shape, parallel_friction] = adjoint_terms();
+
+	// The steps are summed in a different order, only the rounding differs
+	REQUIRE(parallel_shape.size() == serial_shape.size());
+	REQUIRE(parallel_friction.size() == serial_friction.size());
+	CHECK((parallel_shape - serial_shape).norm() <= 1e-10 * serial_shape.norm());
+	CHECK((parallel_friction - serial_friction).norm() <= 1e-10 * serial_friction.norm());
+}
+
 TEST_CASE("shape-transient-friction-sdf", "[test_adjoint]")
 {
 	json opt_args;
@@ -1293,3 +1421,126 @@ TEST_CASE("control-pressure-nodes-3d", "[.][test_adjoint]")
 
 	verify_adjoint(*nl_problem, x, velocity_discrete, 1e-8, 1e-3);
 }
+
+TEST_CASE("adjoint jacobian memory budget", "[test_adjoint]")
+{
+	const int ndof = 10;
+	const int n_steps = 3;
+
+	const auto jacobian = [&](const int nnz_per_col) {
+		std::vector<Eigen::Triplet<double>> triplets;
+		for (int j = 0; j < ndof; ++j)
+			for (int i = 0; i < nnz_per_col; ++i)
+				triplets.emplace_back((i + j) % ndof, j, 1.0 + i);
+		StiffnessMatrix mat(ndof, ndof);
+		mat.setFromTriplets(triplets.begin(), triplets.end());
+		return mat;
+	};
+	const StiffnessMatrix small = jacobian(1), large = jacobian(5);
+
+	DiffCache cache;
+	// Room for two small Jacobians but not for a small and a large one
+	cache.set_jacobian_memory_budget(2 * DiffCache::jacobian_memory(small));
+	cache.init(2, ndof, n_steps);
+
+	const Eigen::VectorXd u = Eigen::VectorXd::Zero(ndof);
+	const auto cache_step = [&](const int step, const StiffnessMatrix &gradu_h) {
+		cache.cache_quantities_transient(
+			step, 1, 0.1 * step, 0.1, u, u, u, gradu_h,
+			ipc::Collisions(), ipc::FrictionCollisions());
+	};
+
+	cache_step(0, StiffnessMatrix(ndof, ndof));
+	cache_step(1, small);
+	CHECK(cache.has_gradu_h(1));
+
+	// The estimate from the last Jacobian allows another one, but the incoming one is too large
+	CHECK(cache.has_jacobian_budget());
+	CHECK(!cache.can_store_jacobian(large));
+	cache_step(2, large);
+	CHECK(!cache.has_gradu_h(2));
+	// The estimate follows the size of the last Jacobian
+	CHECK(!cache.has_jacobian_budget());
+
+	CHECK(cache.can_store_jacobian(small));
+	cache_step(3, small);
+	CHECK(cache.has_gradu_h(3));
+	CHECK(Eigen::MatrixXd(cache.gradu_h(3) - small).norm() == 0);
+}
+
+TEST_CASE("transient force jacobian recomputation", "[test_adjoint]")
+{
+	json opt_args;
+	load_json(append_root_path("shape-transient-friction-opt.json"), opt_args);
+	auto [obj, var2sim, states] = prepare_test(opt_args);
+	State &state = *states[0];
+
+	Eigen::MatrixXd sol, pressure;
+	state.solve_problem(sol, pressure);
+
+	// Same order as the backward sweep of the adjoint, which recomputes the Jacobians over the memory budget
+	int n_friction_collisions = 0;
+	const int time_steps = state.args["time"]["time_steps"];
+	for (int step = time_steps; step > 0; --step)
+	{
+		REQUIRE(state.diff_cached.has_gradu_h(step));
+		const StiffnessMatrix &stored = state.diff_cached.gradu_h(step);
+
+		StiffnessMatrix recomputed;
+		state.recompute_transient_force_jacobian(step, recomputed);
+		REQUIRE(recomputed.rows() == stored.rows());
+		REQUIRE(recomputed.cols() == stored.cols());
+		CHECK((recomputed - stored).norm() <= 1e-8 * stored.norm());
+
+		n_friction_collisions += state.diff_cached.friction_collision_set(step).size();
+	}
+	// The test covers the restoration of the lagged friction collisions
+	CHECK(n_friction_collisions > 0);
+}
+
+TEST_CASE("adjoint jacobian spill file", "[test_adjoint]")
+{
+	const int ndof = 12;
+	const int n_steps = 4;
+	const std::string path = (std::filesystem::temp_directory_path() / "polyfem_test_adjoint_jacobians.bin").string();
+
+	DiffCache cache;
+	cache.set_spill_file(path);
+	cache.init(2, ndof, n_steps);
+
+	std::vector<StiffnessMatrix> jacobians;
+	for (int step = 0; step <= n_steps; ++step)
+	{
+		Eigen::MatrixXd dense = Eigen::MatrixXd::Random(ndof, ndof);
+		dense = (dense.array().abs() > 0.5).select(dense, 0);
+		jacobians.push_back(dense.sparseView());
+
+		const Eigen::VectorXd u = Eigen::VectorXd::Random(ndof);
+		cache.cache_quantities_transient(
+			step, 1, 0.1 * step, 0.1, u, u, u, jacobians.back(),
+			ipc::Collisions(), ipc::FrictionCollisions());
+	}
+
+	// The Jacobian of the initial state is kept in memory, the others are spilled
+	CHECK(cache.has_gradu_h(0));
+	CHECK(!cache.is_gradu_h_spilled(0));
+	for (int step = n_steps; step > 0; --step)
+	{
+		REQUIRE(cache.is_gradu_h_spilled(step));
+		CHECK(!cache.has_gradu_h(step));
+
+		const StiffnessMatrix loaded = cache.load_gradu_h(step);
+		REQUIRE(loaded.rows() == ndof);
+		REQUIRE(loaded.cols() == ndof);
+		CHECK(loaded.nonZeros() == jacobians[step].nonZeros());
+		CHECK(Eigen::MatrixXd(loaded - jacobians[step]).norm() == 0);
+	}
+
+	cache.remove_spill_file();
+	CHECK(!std::filesystem::exists(path));
+	CHECK(!cache.is_gradu_h_spilled(1));
+
+	// The spill files of the states are named after their cache
+	const DiffCache other;
+	CHECK(other.id() != cache.id());
+}
@@ -305,6 +305,65 @@ TEST_CASE("contact form derivatives", "[form][form_derivatives][contact_form]")
 	test_form(form, *state_ptr);
 }
 
+namespace
+{
+	/// Plane below the collision mesh along the first axis, closer than dhat to its lowest vertices
+	mesh::Obstacle::Plane plane_below(const State &state, const double offset)
+	{
+		const Eigen::MatrixXd &V = state.collision_mesh.rest_positions();
+		VectorNd normal = VectorNd::Zero(V.cols());
+		normal(0) = 1;
+		VectorNd point = V.colwise().minCoeff().transpose();
+		point(0) -= offset;
+		return mesh::Obstacle::Plane(point, normal);
+	}
+} // namespace
+
+TEST_CASE("contact form derivatives with planes", "[form][form_derivatives][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	const double dhat = 1e-1;
+	const bool use_convergent_formulation = GENERATE(true, false);
+	const bool is_time_dependent = GENERATE(true, false);
+
+	ContactForm form(
+		state_ptr->collision_mesh, dhat, state_ptr->avg_mass,
+		use_convergent_formulation, /*use_adaptive_barrier_stiffness=*/false,
+		is_time_dependent, false, ipc::BroadPhaseMethod::HASH_GRID, /*ccd_tolerance=*/1e-6,
+		/*ccd_max_iterations=*/1e6);
+	form.set_barrier_stiffness(1e3);
+	form.set_planes({plane_below(*state_ptr, dhat / 2)}, /*n_obstacle_vertices=*/0);
+
+	test_form(form, *state_ptr);
+}
+
+TEST_CASE("friction form derivatives with planes", "[form][form_derivatives][friction_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	const double dhat = 1e-1;
+	const double epsv = 1e-3;
+	const double mu = GENERATE(0.01, 0.1, 1.0);
+	const bool use_convergent_formulation = GENERATE(true, false);
+
+	ContactForm contact_form(
+		state_ptr->collision_mesh, dhat, state_ptr->avg_mass,
+		use_convergent_formulation, /*use_adaptive_barrier_stiffness=*/false,
+		/*is_time_dependent=*/false, false, ipc::BroadPhaseMethod::HASH_GRID, /*ccd_tolerance=*/1e-6,
+		/*ccd_max_iterations=*/1e6);
+	contact_form.set_barrier_stiffness(1e3);
+	contact_form.set_planes({plane_below(*state_ptr, dhat / 2)}, /*n_obstacle_vertices=*/0);
+
+	FrictionForm form(
+		state_ptr->collision_mesh, nullptr, epsv, mu, ipc::BroadPhaseMethod::HASH_GRID, contact_form,
+		/*n_lagging_iters=*/-1);
+
+	test_form(form, *state_ptr);
+}
+
 TEST_CASE("elastic form derivatives", "[form][form_derivatives][elastic_form]")
 {
 	const int dim = GENERATE(2, 3);
@@ -504,6 +563,32 @@ TEST_CASE("BC lagrangian form derivatives", "[form][form_derivatives][bc_lagr_fo
 	}
 }
 
+TEST_CASE("BC lagrangian form warm start history", "[form][bc_lagr_form]")
+{
+	const int ndof = 4;
+	const std::vector<int> boundary_nodes = {0, 3};
+	BCLagrangianForm form(ndof, boundary_nodes, StiffnessMatrix(), 0, Eigen::VectorXd::Zero(ndof));
+
+	form.accept_step(Eigen::VectorXd::Constant(ndof, 1));
+	CHECK(form.predicted_solution().size() == 0);
+
+	// Resizing a step only moves the target, it is not recorded in the history
+	form.update_quantities(0, Eigen::VectorXd::Constant(ndof, 2));
+	CHECK(form.predicted_solution().size() == 0);
+
+	form.accept_step(Eigen::VectorXd::Constant(ndof, 2));
+	CHECK(form.predicted_solution().isApprox(Eigen::VectorXd::Constant(ndof, 3)));
+
+	// The multipliers move by -1 on the boundary DoFs during the next step and are extrapolated once
+	form.update_lagrangian(Eigen::VectorXd::Ones(ndof), 1);
+	form.accept_step(Eigen::VectorXd::Constant(ndof, 3));
+	form.extrapolate_lagrangian();
+	form.extrapolate_lagrangian();
+	CHECK(form.lagrange_multipliers()(0) == -2);
+	CHECK(form.lagrange_multipliers()(1) == 0);
+	CHECK(form.lagrange_multipliers()(3) == -2);
+}
+
 TEST_CASE("BC penalty form derivatives", "[form][form_derivatives][bc_penalty_form]")
 {
 	static const int n_rand = 10;
@@ -247,3 +247,40 @@ TEST_CASE("cache", "[matrix]")
 	REQUIRE(tmp2.coeff(9, 4) == 6);
 	REQUIRE(tmp2.coeff(9, 9) == 4);
 }
+
+TEST_CASE("cache_single_precision", "[matrix]")
+{
+	SparseMatrixCache cache(10);
+	cache.set_single_precision(true);
+	REQUIRE(cache.is_single_precision());
+
+	// first assembly builds the sparsity pattern, the second one uses the float buffer
+	for (int k = 0; k < 2; ++k)
+	{
+		cache.add_value(0, 0, 0, 1);
+		cache.add_value(0, 0, 1, 2);
+		cache.add_value(0, 9, 4, 3);
+		cache.add_value(0, 9, 4, 3);
+		cache.add_value(0, 9, 9, 4);
+
+		const auto tmp = cache.get_matrix();
+
+		REQUIRE(tmp.coeff(0, 0) == 1);
+		REQUIRE(tmp.coeff(0, 1) == 2);
+		REQUIRE(tmp.coeff(9, 4) == 6);
+		REQUIRE(tmp.coeff(9, 9) == 4);
+	}
+
+	SparseMatrixCache cache1(cache);
+	REQUIRE(cache1.is_single_precision());
+	cache1.add_value(0, 0, 0, 1);
+	cache1.add_value(0, 0, 1, 2);
+	cache1.add_value(0, 9, 4, 3);
+	cache1.add_value(0, 9, 4, 3);
+	cache1.add_value(0, 9, 9, 4);
+	cache += cache1;
+
+	const auto tmp = cache.get_matrix();
+	REQUIRE(tmp.coeff(0, 0) == 1);
+	REQUIRE(tmp.coeff(9, 4) == 6);
+}
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+#include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/solver/ForcingTerm.hpp>
+#include <polyfem/solver/forms/Form.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <memory>
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace polyfem;
+using namespace polyfem::solver;
+
+namespace
+{
+	/// Separable quadratic energy 0.5 * sum_i a_i x_i^2 with a settable discrete state
+	class QuadraticForm : public Form
+	{
+	public:
+		QuadraticForm(const Eigen::VectorXd &a) : a_(a) {}
+
+		std::string name() const override { return "quadratic"; }
+
+		size_t hessian_state_hash() const override { return state_; }
+		void set_state(const size_t state) { state_ = state; }
+
+		int n_second_derivatives = 0;
+
+	protected:
+		double value_unweighted(const Eigen::VectorXd &x) const override
+		{
+			return 0.5 * x.dot(a_.cwiseProduct(x));
+		}
+
+		void first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const override
+		{
+			gradv = a_.cwiseProduct(x);
+		}
+
+		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override
+		{
+			++const_cast<QuadraticForm *>(this)->n_second_derivatives;
+			hessian = StiffnessMatrix(a_.asDiagonal());
+		}
+
+	private:
+		const Eigen::VectorXd a_;
+		size_t state_ = 0;
+	};
+
+	/// NLProblem without Dirichlet boundary
+	class UnconstrainedNLProblem : public NLProblem
+	{
+	public:
+		UnconstrainedNLProblem(const int size, const std::vector<std::shared_ptr<Form>> &forms)
+			: NLProblem(size, std::vector<int>(), forms)
+		{
+		}
+	};
+} // namespace
+
+TEST_CASE("hessian reuse", "[nl_problem]")
+{
+	const int n = 5;
+	const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(n, 1, 2);
+	const auto form = std::make_shared<QuadraticForm>(Eigen::VectorXd::LinSpaced(n, 1, 5));
+	UnconstrainedNLProblem problem(n, {form});
+
+	const int max_reuse = 2;
+	problem.set_hessian_reuse(max_reuse, 0.5);
+	problem.init(x);
+
+	StiffnessMatrix hessian;
+	const auto count = [&](const std::string &key) { return problem.hessian_reuse_info()[key].get<int>(); };
+
+	SECTION("Consecutive reuses are bounded")
+	{
+		for (int i = 0; i < 2 * (max_reuse + 1); ++i)
+			problem.hessian(x, hessian);
+		CHECK(count("assemblies") == 2);
+		CHECK(count("reuses") == 2 * max_reuse);
+		CHECK(form->n_second_derivatives == 2);
+		CHECK(Eigen::MatrixXd(hessian).diagonal().isApprox(Eigen::VectorXd::LinSpaced(n, 1, 5)));
+	}
+
+	SECTION("Discrete state or weight changes force an assembly")
+	{
+		problem.hessian(x, hessian);
+		form->set_state(1);
+		problem.hessian(x, hessian);
+		form->set_weight(2);
+		problem.hessian(x, hessian);
+		CHECK(count("assemblies") == 3);
+		CHECK(count("reuses") == 0);
+		CHECK(Eigen::MatrixXd(hessian).diagonal().isApprox(2 * Eigen::VectorXd::LinSpaced(n, 1, 5)));
+
+		problem.hessian(x, hessian);
+		CHECK(count("reuses") == 1);
+	}
+
+	SECTION("Slow convergence forces an assembly")
+	{
+		problem.hessian(x, hessian);
+		problem.post_step(polysolve::nonlinear::PostStepData(0, json::object(), x, Eigen::VectorXd::Constant(n, 1)));
+		problem.post_step(polysolve::nonlinear::PostStepData(1, json::object(), x, Eigen::VectorXd::Constant(n, 0.9)));
+		problem.hessian(x, hessian);
+		CHECK(count("assemblies") == 2);
+		CHECK(count("reuses") == 0);
+	}
+
+	SECTION("Statistics are reported per subsolve")
+	{
+		problem.hessian(x, hessian);
+		problem.hessian(x, hessian);
+		problem.reset_hessian_reuse_info();
+		CHECK(count("assemblies") == 0);
+		CHECK(count("reuses") == 0);
+
+		// The cached Hessian survives the reset of the statistics
+		problem.hessian(x, hessian);
+		CHECK(count("assemblies") == 0);
+		CHECK(count("reuses") == 1);
+	}
+}
+
+TEST_CASE("form timings", "[nl_problem]")
+{
+	const int n = 4;
+	const Eigen::VectorXd x = Eigen::VectorXd::Ones(n);
+	const auto form0 = std::make_shared<QuadraticForm>(Eigen::VectorXd::Ones(n));
+	const auto form1 = std::make_shared<QuadraticForm>(Eigen::VectorXd::Constant(n, 2));
+	FullNLProblem problem({form0, form1});
+	problem.init(x);
+
+	Eigen::VectorXd grad;
+	StiffnessMatrix hessian;
+	for (int i = 0; i < 3; ++i)
+		problem.value(x);
+	problem.gradient(x, grad);
+	problem.hessian(x, hessian);
+	problem.solution_changed(x);
+
+	for (const auto &form : {form0, form1})
+	{
+		const FullNLProblem::FormTimings &timings = problem.form_timings(*form);
+		CHECK(timings.value.count == 3);
+		CHECK(timings.gradient.count == 1);
+		CHECK(timings.hessian.count == 1);
+		CHECK(timings.solution_changed.count == 1);
+		CHECK(timings.max_step_size.count == 0);
+		CHECK(timings.value.time >= 0);
+
+		const json timings_json = timings.to_json();
+		CHECK(timings_json["value"]["calls"] == 3);
+		CHECK(timings_json["hessian"]["calls"] == 1);
+	}
+
+	// Forms that are not part of the problem have no timings
+	const QuadraticForm other(Eigen::VectorXd::Ones(n));
+	CHECK(problem.form_timings(other).value.count == 0);
+
+	problem.reset_form_timings();
+	CHECK(problem.form_timings(*form0).value.count == 0);
+	CHECK(problem.form_timings(*form1).hessian.count == 0);
+}
+
+TEST_CASE("last hessian", "[nl_problem]")
+{
+	const int n = 4;
+	const Eigen::VectorXd x = Eigen::VectorXd::Ones(n);
+	const auto form = std::make_shared<QuadraticForm>(Eigen::VectorXd::LinSpaced(n, 1, 4));
+	FullNLProblem problem({form});
+	problem.init(x);
+
+	StiffnessMatrix hessian, last;
+
+	SECTION("Opt-in")
+	{
+		problem.hessian(x, hessian);
+		CHECK(!problem.last_hessian(x, 0, last));
+	}
+
+	problem.set_keep_last_hessian(true);
+
+	SECTION("Reused at the same solution and weights")
+	{
+		problem.hessian(x, hessian);
+		REQUIRE(problem.last_hessian(x, 0, last));
+		CHECK(Eigen::MatrixXd(last - hessian).norm() == 0);
+
+		const Eigen::VectorXd y = x + Eigen::VectorXd::Constant(n, 1e-3);
+		CHECK(!problem.last_hessian(y, 0, last));
+		CHECK(problem.last_hessian(y, 1e-2, last));
+
+		form->set_weight(2);
+		CHECK(!problem.last_hessian(x, 0, last));
+	}
+
+	SECTION("Projected Hessians are not kept")
+	{
+		problem.set_project_to_psd(true);
+		problem.hessian(x, hessian);
+		CHECK(!problem.last_hessian(x, 0, last));
+
+		problem.set_project_to_psd(false);
+		problem.hessian(x, hessian);
+		CHECK(problem.last_hessian(x, 0, last));
+	}
+
+	SECTION("Dropped when the forms change")
+	{
+		problem.hessian(x, hessian);
+		problem.update_lagging(x, 1);
+		CHECK(!problem.last_hessian(x, 0, last));
+	}
+}
+
+TEST_CASE("inexact newton forcing term", "[nl_problem]")
+{
+	json args = {
+		{"min_forcing_term", 1e-8},
+		{"max_forcing_term", 0.1},
+		{"gamma", 0.9},
+		{"alpha", 2}};
+
+	SECTION("Follows the residual decrease")
+	{
+		ForcingTerm forcing_term(args);
+		CHECK(forcing_term.eta() == Catch::Approx(0.1));
+		// No previous residual: the first solve uses the maximum forcing term
+		CHECK(forcing_term.update(1) == Catch::Approx(0.1));
+		CHECK(forcing_term.update(0.1) == Catch::Approx(0.9 * 0.1 * 0.1));
+		// Stagnation is clamped to the maximum
+		CHECK(forcing_term.update(0.1) == Catch::Approx(0.1));
+		// A converged residual keeps the current forcing term
+		CHECK(forcing_term.update(0) == Catch::Approx(0.1));
+	}
+
+	SECTION("Clamped to the minimum")
+	{
+		ForcingTerm forcing_term(args);
+		forcing_term.update(1);
+		CHECK(forcing_term.update(1e-10) == Catch::Approx(1e-8));
+	}
+
+	SECTION("Safeguard against a sudden decrease")
+	{
+		args["max_forcing_term"] = 0.5;
+		ForcingTerm forcing_term(args);
+		forcing_term.update(1);
+		// gamma * eta^alpha = 0.225 > 0.1 bounds the new forcing term from below
+		CHECK(forcing_term.update(0.01) == Catch::Approx(0.9 * 0.5 * 0.5));
+	}
+}
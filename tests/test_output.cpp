@@ -4,10 +4,16 @@
 
 #include <polyfem/State.hpp>
 #include <polyfem/Common.hpp>
+#include <polyfem/io/OutputQueue.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <stdexcept>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -82,3 +88,119 @@ TEST_CASE("full sim", "[.][full_sim]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+#ifdef NDEBUG
+TEST_CASE("async output", "[full_sim]")
+#else
+TEST_CASE("async output", "[.][full_sim]")
+#endif
+{
+	const std::string scene_file = fmt::format("{}/contact/examples/2D/unit-tests/5-squares.json", POLYFEM_DATA_DIR);
+
+	json args;
+	if (!load_json(scene_file, args))
+	{
+		spdlog::error("unable to open {} file", scene_file);
+		FAIL();
+	}
+
+	args["root_path"] = scene_file;
+	args["/output/paraview/file_name"_json_pointer] = "sim.pvd";
+	args["/output/paraview/options/velocity"_json_pointer] = true;
+	args["/output/paraview/options/contact_forces"_json_pointer] = true;
+	args["/solver/linear/solver"_json_pointer] = "Eigen::SimplicialLDLT";
+	args["/output/log/level"_json_pointer] = "warning";
+
+	const std::filesystem::path outdir = std::filesystem::current_path() / "DELETE_ME_async_output_test_output";
+
+	const auto run = [&](const bool async, const std::filesystem::path &dir) {
+		json run_args = args;
+		run_args["/output/directory"_json_pointer] = dir.string();
+		run_args["/output/advanced/async/enabled"_json_pointer] = async;
+		run_args["/output/advanced/async/max_pending"_json_pointer] = 1;
+
+		State state;
+		state.init(run_args, true);
+		state.load_mesh();
+		REQUIRE(state.mesh != nullptr);
+		state.build_basis();
+		state.assemble_rhs();
+		state.assemble_mass_mat();
+
+		Eigen::MatrixXd sol, pressure;
+		state.solve_problem(sol, pressure);
+	};
+
+	run(false, outdir / "sync");
+	run(true, outdir / "async");
+
+	// The frames written in the background are the ones written by the solver thread
+	int n_files = 0;
+	for (const auto &entry : std::filesystem::directory_iterator(outdir / "sync"))
+	{
+		if (entry.path().extension() != ".vtu")
+			continue;
+		const std::filesystem::path async_path = outdir / "async" / entry.path().filename();
+		REQUIRE(std::filesystem::exists(async_path));
+
+		std::ifstream sync_file(entry.path(), std::ios::binary), async_file(async_path, std::ios::binary);
+		const std::string sync_content((std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>());
+		const std::string async_content((std::istreambuf_iterator<char>(async_file)), std::istreambuf_iterator<char>());
+		CAPTURE(entry.path().filename().string());
+		CHECK(sync_content == async_content);
+		n_files++;
+	}
+	CHECK(n_files > 1);
+
+	std::filesystem::remove_all(outdir);
+}
+
+TEST_CASE("output queue", "[output]")
+{
+	SECTION("Submission order")
+	{
+		std::vector<int> order;
+		io::OutputQueue queue(1, 4);
+		for (int i = 0; i < 20; ++i)
+			queue.push([&order, i]() { order.push_back(i); });
+		queue.wait();
+
+		REQUIRE(order.size() == 20);
+		for (int i = 0; i < 20; ++i)
+			CHECK(order[i] == i);
+	}
+
+	SECTION("Push blocks while the queue is full")
+	{
+		io::OutputQueue queue(1, 1);
+		std::promise<void> started, release;
+		std::shared_future<void> released = release.get_future().share();
+		std::atomic<int> n_done = 0;
+
+		// The worker is busy with the first task and the second one fills the queue
+		queue.push([&, released]() { started.set_value(); released.wait(); ++n_done; });
+		started.get_future().wait();
+		queue.push([&]() { ++n_done; });
+
+		std::future<void> blocked_push = std::async(std::launch::async, [&]() { queue.push([&]() { ++n_done; }); });
+		CHECK(blocked_push.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+
+		release.set_value();
+		blocked_push.get();
+		queue.wait();
+		CHECK(n_done == 3);
+	}
+
+	SECTION("Errors are rethrown once")
+	{
+		io::OutputQueue queue(2, 4);
+		queue.push([]() { throw std::runtime_error("failed output"); });
+		CHECK_THROWS_AS(queue.wait(), std::runtime_error);
+		CHECK_NOTHROW(queue.wait());
+
+		bool ran = false;
+		queue.push([&ran]() { ran = true; });
+		queue.wait();
+		CHECK(ran);
+	}
+}
@@ -5,8 +5,10 @@
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/Logger.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/io/Snapshot.hpp>
 
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -122,3 +124,183 @@ TEST_CASE("restart", "[.][restart]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("snapshot", "[restart]")
+{
+	const std::filesystem::path outdir = std::filesystem::current_path() / "DELETE_ME_snapshot_test_output";
+	std::filesystem::create_directories(outdir);
+	const std::string path = (outdir / "snapshot.bin").string();
+
+	io::Snapshot snapshot;
+	const Eigen::MatrixXd x = Eigen::MatrixXd::Random(7, 3);
+	const Eigen::MatrixXd empty;
+	snapshot.set("x", x);
+	snapshot.set("empty", empty);
+	snapshot.set("dt", 0.25);
+	snapshot.write(path);
+
+	SECTION("round trip")
+	{
+		io::Snapshot loaded;
+		loaded.set("stale", 1.0);
+		loaded.read(path);
+
+		CHECK(!loaded.has("stale"));
+		REQUIRE(loaded.has("x"));
+		CHECK(loaded.get("x") == x);
+		CHECK(loaded.get("empty").size() == 0);
+		CHECK(loaded.get_scalar("dt") == 0.25);
+		CHECK_THROWS(loaded.get("missing"));
+		CHECK_THROWS(loaded.get_scalar("x"));
+	}
+
+	SECTION("truncated")
+	{
+		const auto size = std::filesystem::file_size(path);
+		std::filesystem::resize_file(path, size - sizeof(double));
+
+		io::Snapshot loaded;
+		CHECK_THROWS(loaded.read(path));
+	}
+
+	SECTION("not a snapshot")
+	{
+		{
+			std::ofstream file(path);
+			file << "{}";
+		}
+
+		io::Snapshot loaded;
+		CHECK_THROWS(loaded.read(path));
+	}
+
+	std::filesystem::remove_all(outdir);
+}
+
+#ifdef NDEBUG
+TEST_CASE("adaptive time step rollback", "[restart]")
+#else
+TEST_CASE("adaptive time step rollback", "[.][restart]")
+#endif
+{
+	const std::string scene_file = POLYFEM_DATA_DIR "/contact/examples/3D/unit-tests/2-cubes.json";
+	constexpr int time_steps = 2;
+	constexpr int substeps = 4;
+	constexpr double margin = 1e-3;
+
+	const std::filesystem::path outdir = std::filesystem::current_path() / "DELETE_ME_adaptive_test_output";
+
+	json args = load_sim_json(scene_file, time_steps);
+	const double dt = args["/time/dt"_json_pointer];
+
+	// The error tolerance rejects every step until it reaches the minimum step size
+	json adaptive_args = args;
+	adaptive_args["/output/directory"_json_pointer] = (outdir / "adaptive").string();
+	adaptive_args["/time/adaptive/enabled"_json_pointer] = true;
+	adaptive_args["/time/adaptive/error_tolerance"_json_pointer] = 1e-12;
+	adaptive_args["/time/adaptive/min_dt_ratio"_json_pointer] = 1.0 / substeps;
+	adaptive_args["/time/adaptive/max_dt_ratio"_json_pointer] = 1;
+	adaptive_args["/time/adaptive/shrink"_json_pointer] = 0.5;
+
+	State adaptive_state;
+	const auto adaptive_sol = run_sim(adaptive_state, adaptive_args);
+
+	int n_rejected = 0;
+	for (const json &info : adaptive_state.stats.solver_info)
+		if (info.value("type", "") == "rejected_step")
+			n_rejected++;
+	CHECK(n_rejected == 2);
+
+	// The rolled back steps must not leave any trace in the solution
+	json fixed_args = args;
+	fixed_args["/output/directory"_json_pointer] = (outdir / "fixed").string();
+	fixed_args["/time/dt"_json_pointer] = dt / substeps;
+	fixed_args["/time/time_steps"_json_pointer] = time_steps * substeps;
+
+	State fixed_state;
+	const auto fixed_sol = run_sim(fixed_state, fixed_args);
+
+	CHECK(fixed_sol.rows() == adaptive_sol.rows());
+	CAPTURE((fixed_sol - adaptive_sol).lpNorm<Eigen::Infinity>());
+	CHECK(fixed_sol.isApprox(adaptive_sol, margin));
+
+	std::filesystem::remove_all(outdir);
+}
+
+#ifdef NDEBUG
+TEST_CASE("quasi-static extrapolation", "[restart]")
+#else
+TEST_CASE("quasi-static extrapolation", "[.][restart]")
+#endif
+{
+	const std::string scene_file = POLYFEM_DATA_DIR "/contact/examples/3D/unit-tests/2-cubes.json";
+	constexpr int time_steps = 4;
+	constexpr double margin = 1e-3;
+
+	const std::filesystem::path outdir = std::filesystem::current_path() / "DELETE_ME_extrapolation_test_output";
+
+	json args = load_sim_json(scene_file, time_steps);
+	args["/time/quasistatic"_json_pointer] = true;
+
+	json default_args = args;
+	default_args["/output/directory"_json_pointer] = (outdir / "default").string();
+	State default_state;
+	const auto default_sol = run_sim(default_state, default_args);
+
+	// Only the initial guesses change, the steps converge to the same solutions
+	json extrapolated_args = args;
+	extrapolated_args["/output/directory"_json_pointer] = (outdir / "extrapolated").string();
+	extrapolated_args["/solver/advanced/quasistatic_extrapolation"_json_pointer] = true;
+	State extrapolated_state;
+	const auto extrapolated_sol = run_sim(extrapolated_state, extrapolated_args);
+
+	CHECK(default_sol.rows() == extrapolated_sol.rows());
+	CAPTURE((default_sol - extrapolated_sol).lpNorm<Eigen::Infinity>());
+	CHECK(default_sol.isApprox(extrapolated_sol, margin));
+
+	std::filesystem::remove_all(outdir);
+}
+
+#ifdef NDEBUG
+TEST_CASE("snapshot restart", "[restart]")
+#else
+TEST_CASE("snapshot restart", "[.][restart]")
+#endif
+{
+	const std::string scene_file = POLYFEM_DATA_DIR "/contact/examples/3D/unit-tests/2-cubes.json";
+	constexpr int total_time_steps = 6;
+	constexpr int restart_time_steps = total_time_steps / 2;
+	constexpr double margin = 1e-6;
+
+	const std::filesystem::path outdir = std::filesystem::current_path() / "DELETE_ME_snapshot_restart_test_output";
+	const std::filesystem::path full_outdir = outdir / "full";
+	const std::filesystem::path restart_outdir = outdir / "restart";
+
+	json args = load_sim_json(scene_file, total_time_steps);
+	// Friction lagging, augmented Lagrangian and predictor all carry state from one step to the next
+	args["/contact/friction_coefficient"_json_pointer] = 0.2;
+	args["/time/predictor/rank"_json_pointer] = 2;
+
+	State full_state;
+	args["/output/directory"_json_pointer] = full_outdir.string();
+	args["/output/data/snapshot"_json_pointer] = "snapshot_{:d}.bin";
+	const auto full_sol = run_sim(full_state, args);
+
+	const std::filesystem::path snapshot_path = full_outdir / fmt::format("snapshot_{:d}.bin", restart_time_steps);
+	REQUIRE(std::filesystem::exists(snapshot_path));
+
+	// The snapshot alone restores the solution, no hdf5 state is given
+	State restart_state;
+	args["/output/directory"_json_pointer] = restart_outdir.string();
+	args["/output/data/snapshot"_json_pointer] = "";
+	args["/input/data/snapshot"_json_pointer] = snapshot_path.string();
+	args["/time/t0"_json_pointer] = args["/time/dt"_json_pointer].get<double>() * restart_time_steps;
+	args["time"]["time_steps"] = restart_time_steps;
+	const auto restart_sol = run_sim(restart_state, args);
+
+	REQUIRE(full_sol.rows() == restart_sol.rows());
+	CAPTURE((full_sol - restart_sol).lpNorm<Eigen::Infinity>());
+	CHECK(full_sol.isApprox(restart_sol, margin));
+
+	std::filesystem::remove_all(outdir);
+}
@@ -5,6 +5,7 @@
 #include <finitediff.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
@@ -100,4 +101,141 @@ TEST_CASE("time integrator", "[time_integrator]")
 		x.setRandom();
 		x /= 100;
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("local error estimate", "[time_integrator]")
+{
+	const double dt = GENERATE(0.1, 0.01);
+	const int n = 10;
+	const double t = 0; // the history and the error terms have the same magnitude (no cancellation)
+	const Eigen::VectorXd c = Eigen::VectorXd::LinSpaced(n, -1, 1);
+
+	// k-th derivative of the trajectory c t^m / m!, its local error terms are exact
+	const auto derivative = [&](const int m, const int k, const double time) -> Eigen::VectorXd {
+		double scale = 1;
+		for (int i = 2; i <= m - k; ++i)
+			scale *= i;
+		return c * std::pow(time, m - k) / scale;
+	};
+
+	SECTION("Implicit Euler and BDF")
+	{
+		const int steps = GENERATE(1, 2, 3, 4, 5, 6);
+		const int m = steps + 1;
+
+		std::shared_ptr<ImplicitTimeIntegrator> time_integrator;
+		if (steps == 1)
+			time_integrator = std::make_shared<ImplicitEuler>();
+		else
+			time_integrator = std::make_shared<BDF>(steps);
+
+		Eigen::MatrixXd x_prevs(n, steps), v_prevs(n, steps), a_prevs(n, steps);
+		for (int i = 0; i < steps; ++i)
+		{
+			x_prevs.col(i) = derivative(m, 0, t - i * dt);
+			v_prevs.col(i) = derivative(m, 1, t - i * dt);
+			a_prevs.col(i) = derivative(m, 2, t - i * dt);
+		}
+		time_integrator->init(x_prevs, v_prevs, a_prevs, dt);
+		CHECK(time_integrator->order() == steps);
+
+		// Step of the position update with the exact velocity at the end of the step
+		const std::vector<double> &alphas = BDF::alphas(steps - 1);
+		const double beta = BDF::betas(steps - 1);
+		Eigen::VectorXd x = beta * dt * derivative(m, 1, t + dt);
+		for (int i = 0; i < steps; ++i)
+			x += alphas[i] * x_prevs.col(i);
+
+		const double error = (derivative(m, 0, t + dt) - x).lpNorm<Eigen::Infinity>();
+		CHECK(time_integrator->estimate_local_error(x) == Catch::Approx(error).epsilon(1e-6));
+	}
+
+	SECTION("Implicit Newmark")
+	{
+		const auto time_integrator = std::make_shared<ImplicitNewmark>();
+		const double beta = time_integrator->beta();
+		const int m = 3;
+
+		time_integrator->init(derivative(m, 0, t), derivative(m, 1, t), derivative(m, 2, t), dt);
+		CHECK(time_integrator->order() == 2);
+
+		const Eigen::VectorXd x = derivative(m, 0, t) + dt * derivative(m, 1, t)
+								  + 0.5 * dt * dt * ((1 - 2 * beta) * derivative(m, 2, t) + 2 * beta * derivative(m, 2, t + dt));
+
+		const double error = (derivative(m, 0, t + dt) - x).lpNorm<Eigen::Infinity>();
+		CHECK(time_integrator->estimate_local_error(x) == Catch::Approx(error).epsilon(1e-6));
+	}
+}
+
+TEST_CASE("reduced order predictor", "[time_integrator]")
+{
+	const int n = 10;
+	const int rank = GENERATE(2, 3);
+
+	// The solution increments span a plane
+	Eigen::MatrixXd directions = Eigen::MatrixXd::Random(n, 2);
+	ImplicitEuler time_integrator;
+	time_integrator.init(Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), 0.1);
+	time_integrator.set_predictor_parameters(rank, 1);
+	CHECK(time_integrator.predictor_basis().cols() == 0);
+
+	Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+	for (int i = 0; i < 6; ++i)
+	{
+		x += directions * Eigen::Vector2d::Random();
+		time_integrator.update_predictor(x);
+
+		const Eigen::MatrixXd &basis = time_integrator.predictor_basis();
+		REQUIRE(basis.rows() == n);
+		CHECK(basis.cols() <= std::min(i + 1, 2));
+		CHECK((basis.transpose() * basis - Eigen::MatrixXd::Identity(basis.cols(), basis.cols())).norm() < 1e-10);
+	}
+
+	// A rank larger than the span of the increments is truncated to the plane
+	const Eigen::MatrixXd &basis = time_integrator.predictor_basis();
+	REQUIRE(basis.cols() == 2);
+	CHECK((directions - basis * (basis.transpose() * directions)).norm() < 1e-10 * directions.norm());
+
+	// An increment out of the plane is kept only if the rank allows it
+	x += Eigen::VectorXd::Random(n);
+	time_integrator.update_predictor(x);
+	CHECK(time_integrator.predictor_basis().cols() == std::min(rank, 3));
+	CHECK((time_integrator.predictor_basis().transpose() * time_integrator.predictor_basis()
+		   - Eigen::MatrixXd::Identity(time_integrator.predictor_basis().cols(), time_integrator.predictor_basis().cols()))
+			  .norm()
+		  < 1e-10);
+}
+
+TEST_CASE("reduced order predictor orthogonality", "[time_integrator]")
+{
+	const int n = 50;
+	const int rank = 4;
+
+	ImplicitEuler time_integrator;
+	time_integrator.init(Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), 0.1);
+	time_integrator.set_predictor_parameters(rank, 0.9);
+
+	// Increments almost in the current subspace with a tiny perturbation accumulate rounding errors in the basis
+	const Eigen::MatrixXd directions = Eigen::MatrixXd::Random(n, rank);
+	Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+	for (int i = 0; i < 1000; ++i)
+	{
+		x += directions * Eigen::VectorXd::Random(rank) + 1e-9 * Eigen::VectorXd::Random(n);
+		time_integrator.update_predictor(x);
+
+		const Eigen::MatrixXd &basis = time_integrator.predictor_basis();
+		REQUIRE(basis.cols() <= rank);
+		REQUIRE((basis.transpose() * basis - Eigen::MatrixXd::Identity(basis.cols(), basis.cols())).lpNorm<Eigen::Infinity>() < 1e-9);
+	}
+
+	const Eigen::MatrixXd &basis = time_integrator.predictor_basis();
+	REQUIRE(basis.cols() == rank);
+	CHECK((directions - basis * (basis.transpose() * directions)).norm() < 1e-6 * directions.norm());
+
+	// Replacing the history keeps the subspace, initializing resets it
+	const Eigen::MatrixXd kept_basis = basis;
+	time_integrator.set_history(x, Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), 0.1);
+	CHECK(time_integrator.predictor_basis() == kept_basis);
+	time_integrator.init(x, Eigen::VectorXd::Zero(n), Eigen::VectorXd::Zero(n), 0.1);
+	CHECK(time_integrator.predictor_basis().cols() == 0);
+}